@@ -210,6 +210,13 @@
     #define MAX_AUTORETRACT 99
   #endif
 
+  /**
+   * Provide a BABYSTEP_MAX_RATE for older configs
+   */
+  #if ENABLED(BABYSTEPPING) && !defined(BABYSTEP_MAX_RATE)
+    #define BABYSTEP_MAX_RATE 2000
+  #endif
+
   /**
    * MAX_STEP_FREQUENCY differs for TOSHIBA
    */
@@ -1147,4 +1154,10 @@
     #endif
   #endif
 
+  // The planner keeps an estimate of the queued motion time
+  #define HAS_BLOCK_BUFFER_RUNTIME (ENABLED(ULTRA_LCD) || ENABLED(ADAPTIVE_SLOWDOWN) || ENABLED(PLANNER_TIME_WATERMARK))
+
+  // Timer1 is shared by the stepper ISR and a second source of steps
+  #define HAS_STEPPER_SCHEDULER ENABLED(INPUT_SHAPING)
+
 #endif // CONDITIONALS_POST_H
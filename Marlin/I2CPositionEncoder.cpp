@@ -40,6 +40,14 @@
 
   #include <Wire.h>
 
+  #if ENABLED(USE_WATCHDOG)
+    #include "watchdog.h"
+  #endif
+
+  #if ENABLED(I2CPE_ASYNC_READ)
+    #include <util/twi.h>
+  #endif
+
 
   void I2CPositionEncoder::init(const uint8_t address, const AxisEnum axis) {
     encoderAxis = axis;
@@ -56,7 +64,12 @@
   void I2CPositionEncoder::update() {
     if (!initialised || !homed || !active) return; //check encoder is set up and active
 
-    position = get_position();
+    #if ENABLED(I2CPE_ASYNC_READ)
+      sampleFresh = false;
+      position = sampleCount - zeroOffset;  // latest background reading; no waiting on the bus
+    #else
+      position = get_position();
+    #endif
 
     //we don't want to stop things just because the encoder missed a message,
     //so we only care about responses that indicate bad magnetic strength
@@ -127,7 +140,11 @@
     }
 
     lastPosition = position;
-    const millis_t positionTime = millis();
+    #if ENABLED(I2CPE_ASYNC_READ)
+      const millis_t positionTime = sampleTime;
+    #else
+      const millis_t positionTime = millis();
+    #endif
 
     //only do error correction if setup and enabled
     if (ec && ecMethod != I2CPE_ECM_NONE) {
@@ -216,6 +233,10 @@
       homed++;
       trusted++;
 
+      #if ENABLED(I2CPE_ASYNC_READ)
+        sampleFresh = false;  // anything read before now predates the new zero
+      #endif
+
       #ifdef I2CPE_DEBUG
         SERIAL_ECHO(axis_codes[encoderAxis]);
         SERIAL_ECHOPAIR(" axis encoder homed, offset of ", zeroOffset);
@@ -281,7 +302,12 @@
     //convert both 'ticks' into same units / base
     encoderCountInStepperTicksScaled = LROUND((stepperTicksPerUnit * encoderTicks) / encoderTicksPerUnit);
 
-    int32_t target = stepper.position(encoderAxis),
+    #if ENABLED(I2CPE_ASYNC_READ)
+      // Compare with where the steppers were when the encoder was read
+      int32_t target = sampleSteps,
+    #else
+      int32_t target = stepper.position(encoderAxis),
+    #endif
             error = (encoderCountInStepperTicksScaled - target);
 
     //suppress discontinuities (might be caused by bad I2C readings...?)
@@ -307,6 +333,10 @@
 
     encoderCount.val = 0x00;
 
+    #if ENABLED(I2CPE_ASYNC_READ)
+      I2CPEM.finish_read();
+    #endif
+
     if (Wire.requestFrom((int)i2cAddress, 3) != 3) {
       //houston, we have a problem...
       H = I2CPE_MAG_SIG_NF;
@@ -316,6 +346,10 @@
     while (Wire.available())
       encoderCount.bval[index++] = (uint8_t)Wire.read();
 
+    return decode_count(encoderCount);
+  }
+
+  int32_t I2CPositionEncoder::decode_count(i2cLong &encoderCount) {
     //extract the magnetic strength
     H = (B00000011 & (encoderCount.bval[2] >> 6));
 
@@ -465,7 +499,139 @@
     SERIAL_ECHOLNPGM("Calculated steps per mm has been set. Please save to EEPROM (M500) if you wish to keep these values.");
   }
 
+  #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+
+    static int16_t ringing_sample[I2CPE_RINGING_SAMPLES];
+
+    /**
+     * Make a short move at the given acceleration and sample the encoder while
+     * the axis settles. The frequency comes from the zero crossings around the
+     * settled position, and the damping from the decay of the half-cycle peaks.
+     */
+    bool I2CPositionEncoder::measure_ringing(const float accel, const float distance, float &freq, float &zeta, float &amplitude) {
+      //only works on XYZ cartesian machines for the time being
+      if (!(encoderAxis == X_AXIS || encoderAxis == Y_AXIS || encoderAxis == Z_AXIS)) return false;
+
+      float coord[NUM_AXIS];
+
+      stepper.synchronize();
+
+      LOOP_NA(i) coord[i] = stepper.get_axis_position_mm((AxisEnum)i);
+
+      // Move away from the nearer end of travel
+      coord[encoderAxis] += (coord[encoderAxis] + distance <= soft_endstop_max[encoderAxis]) ? distance : -distance;
+
+      const bool oldec = ec;
+      const float old_accel = planner.travel_acceleration;
+      ec = false;
+      planner.travel_acceleration = accel;
+
+      planner.buffer_line(coord[X_AXIS], coord[Y_AXIS], coord[Z_AXIS], coord[E_AXIS], planner.max_feedrate_mm_s[encoderAxis], 0);
+
+      // Start sampling as soon as the steppers stop. No idle() here, it could take too long,
+      // but keep the heaters and the watchdog going through a long or gentle move.
+      while (planner.blocks_queued()
+        #if ENABLED(INPUT_SHAPING)
+          || stepper.shaping_busy()
+        #endif
+      ) {
+        thermalManager.manage_heater();
+        #if ENABLED(USE_WATCHDOG)
+          watchdog_reset();
+        #endif
+      }
+
+      const int32_t start = get_raw_count();
+      const uint32_t first = micros();
+      uint32_t next = first;
+      bool ok = true;
+      for (uint16_t i = 0; i < I2CPE_RINGING_SAMPLES; i++) {
+        while ((int32_t)(micros() - next) < 0) { /* nada */ }
+        next += I2CPE_RINGING_INTERVAL;
+        ringing_sample[i] = constrain(get_raw_count() - start, -32767, 32767);
+        if (H == I2CPE_MAG_SIG_NF) ok = false;
+      }
+      const float interval = (micros() - first) * 0.000001f / I2CPE_RINGING_SAMPLES; // (s) Measured, in case of slow reads
+
+      planner.travel_acceleration = old_accel;
+      ec = oldec;
+
+      if (!ok) return false;
+
+      // The axis should have settled by the last quarter
+      int32_t sum = 0;
+      for (uint16_t i = I2CPE_RINGING_SAMPLES * 3 / 4; i < I2CPE_RINGING_SAMPLES; i++) sum += ringing_sample[i];
+      const int16_t rest = sum / (I2CPE_RINGING_SAMPLES - I2CPE_RINGING_SAMPLES * 3 / 4);
+
+      // Ignore crossings smaller than a fraction of the largest swing
+      int16_t swing = 0;
+      for (uint16_t i = 0; i < I2CPE_RINGING_SAMPLES; i++) NOLESS(swing, abs(ringing_sample[i] - rest));
+      const int16_t hysteresis = max(2, swing / 8);
+
+      // Find the zero crossings (interpolated) and the peak of each half-cycle
+      float first_cross = 0, last_cross = 0, first_peak = 0, last_peak = 0;
+      uint8_t crossings = 0;
+      int8_t side = 0;
+      int16_t peak = 0;
+      for (uint16_t i = 0; i < I2CPE_RINGING_SAMPLES; i++) {
+        const int16_t x = ringing_sample[i] - rest;
+        if (abs(x) > abs(peak)) peak = x;
+        if ((side >= 0 && x < -hysteresis) || (side <= 0 && x > hysteresis)) {
+          if (side) {
+            // Back up to where the signal crossed the rest position
+            uint16_t j = i;
+            while (j > 1 && (ringing_sample[j - 1] - rest) * side < 0) j--;
+            const int16_t a = ringing_sample[j - 1] - rest, b = ringing_sample[j] - rest;
+            const float at = j - 1 + (a == b ? 0 : (float)a / (a - b));
+            if (!crossings) first_cross = at;
+            last_cross = at;
+
+            // Close the half-cycle
+            if (crossings) last_peak = abs(peak); else first_peak = abs(peak);
+            crossings++;
+            peak = x;
+          }
+          side = x > 0 ? 1 : -1;
+        }
+      }
+
+      if (crossings < 3 || last_cross <= first_cross) return false;
+
+      // Half a period between crossings
+      freq = (crossings - 1) / (2 * (last_cross - first_cross) * interval);
+
+      // Logarithmic decrement per full period, from the first and last whole half-cycles
+      const float decrement = last_peak > 0 && first_peak > last_peak ? 2 * log(first_peak / last_peak) / (crossings - 1) : 0;
+      zeta = decrement / SQRT(sq(2 * M_PI) + sq(decrement));
+
+      amplitude = (float)swing / get_encoder_ticks_mm();
+      return true;
+    }
+
+  #endif // I2CPE_RINGING_MEASUREMENT
+
+  #if ENABLED(I2CPE_ASYNC_READ)
+
+    void I2CPositionEncoder::set_sample(i2cLong &encoderCount, const int32_t steps, const millis_t ms) {
+      sampleCount = decode_count(encoderCount);
+      sampleSteps = steps;
+      sampleTime = ms;
+      sampleFresh = true;
+    }
+
+    // A failed read is still handed to update() so the fault is noticed
+    void I2CPositionEncoder::set_sample_failed(const millis_t ms) {
+      H = I2CPE_MAG_SIG_NF;
+      sampleTime = ms;
+      sampleFresh = true;
+    }
+
+  #endif // I2CPE_ASYNC_READ
+
   void I2CPositionEncoder::reset() {
+    #if ENABLED(I2CPE_ASYNC_READ)
+      I2CPEM.finish_read();
+    #endif
     Wire.beginTransmission(i2cAddress);
     Wire.write(I2CPE_RESET_COUNT);
     Wire.endTransmission();
@@ -481,6 +647,104 @@
           I2CPositionEncodersMgr::I2CPE_idx;
   I2CPositionEncoder I2CPositionEncodersMgr::encoders[I2CPE_ENCODER_CNT];
 
+  #if ENABLED(I2CPE_ASYNC_READ)
+
+    enum I2CPEBusState : char { I2CPE_BUS_IDLE, I2CPE_BUS_START, I2CPE_BUS_ADDRESS, I2CPE_BUS_DATA };
+
+    // TWCR with the Wire library's interrupt and ACK bits, as it expects to find the bus at rest
+    #define I2CPE_TWCR_WIRE (_BV(TWEN) | _BV(TWIE) | _BV(TWEA))
+
+    uint8_t I2CPositionEncodersMgr::busState = I2CPE_BUS_IDLE,
+            I2CPositionEncodersMgr::busIdx = 0,
+            I2CPositionEncodersMgr::busCount;
+    i2cLong I2CPositionEncodersMgr::busData;
+    int32_t I2CPositionEncodersMgr::busSteps;
+    millis_t I2CPositionEncodersMgr::busStart,
+             I2CPositionEncodersMgr::busEvent;
+
+    /**
+     * Advance the background encoder read by one bus event, never waiting on the bus.
+     * Encoders that update() would check are read in turn, and each reading is published
+     * with the time and stepper position at which it was requested.
+     *
+     * The TWI interrupt belongs to the Wire library, so the bus is driven with TWIE clear
+     * and this is called from idle() instead. Each call costs a few register accesses.
+     */
+    void I2CPositionEncodersMgr::bus_step(const bool start) {
+      if (busState == I2CPE_BUS_IDLE) {
+        if (!start || TEST(TWCR, TWSTO)) return;   // Previous STOP not sent yet
+        LOOP_PE(i) {
+          busIdx = (busIdx + 1) % (I2CPE_ENCODER_CNT);
+          if (encoders[busIdx].is_polled()) {
+            busStart = busEvent = millis();
+            busSteps = stepper.position(encoders[busIdx].get_axis());
+            TWCR = _BV(TWINT) | _BV(TWSTA) | _BV(TWEN);
+            busState = I2CPE_BUS_START;
+            return;
+          }
+        }
+        return;
+      }
+
+      // A slow read is fine as long as the bus keeps moving
+      if (!TEST(TWCR, TWINT)) {
+        if (ELAPSED(millis(), busEvent + I2CPE_BUS_TIMEOUT_MS)) {
+          TWCR = 0;                                   // Stuck bus; reset the TWI and give up on this read
+          TWCR = I2CPE_TWCR_WIRE;
+          busState = I2CPE_BUS_IDLE;
+          encoders[busIdx].set_sample_failed(busStart);
+        }
+        return;
+      }
+      busEvent = millis();
+
+      const uint8_t status = TW_STATUS;
+      switch (busState) {
+        case I2CPE_BUS_START:
+          if (status != TW_START) break;
+          TWDR = (encoders[busIdx].get_address() << 1) | TW_READ;
+          TWCR = _BV(TWINT) | _BV(TWEN);
+          busState = I2CPE_BUS_ADDRESS;
+          return;
+
+        case I2CPE_BUS_ADDRESS:
+          if (status != TW_MR_SLA_ACK) break;
+          busCount = 0;
+          TWCR = _BV(TWINT) | _BV(TWEN) | _BV(TWEA);
+          busState = I2CPE_BUS_DATA;
+          return;
+
+        case I2CPE_BUS_DATA:
+          if (status != (busCount < 2 ? TW_MR_DATA_ACK : TW_MR_DATA_NACK)) break;
+          busData.bval[busCount++] = TWDR;
+          if (busCount < 3) {
+            TWCR = _BV(TWINT) | _BV(TWEN) | (busCount < 2 ? _BV(TWEA) : 0);  // NACK the last byte
+            return;
+          }
+          busData.bval[3] = 0;
+          TWCR = I2CPE_TWCR_WIRE | _BV(TWINT) | _BV(TWSTO);
+          busState = I2CPE_BUS_IDLE;
+          encoders[busIdx].set_sample(busData, busSteps, busStart);
+          return;
+      }
+
+      // No answer or lost arbitration
+      TWCR = I2CPE_TWCR_WIRE | _BV(TWINT) | _BV(TWSTO);
+      busState = I2CPE_BUS_IDLE;
+      encoders[busIdx].set_sample_failed(busStart);
+    }
+
+    /**
+     * Complete any background read and wait for the bus to be released,
+     * so the Wire library can be used. Must be called before every Wire transaction.
+     */
+    void I2CPositionEncodersMgr::finish_read() {
+      while (busState != I2CPE_BUS_IDLE) bus_step(false);
+      while (TEST(TWCR, TWSTO)) { /* nada */ }
+    }
+
+  #endif // I2CPE_ASYNC_READ
+
   void I2CPositionEncodersMgr::init() {
     Wire.begin();
 
@@ -664,6 +928,10 @@
   }
 
   void I2CPositionEncodersMgr::change_module_address(const uint8_t oldaddr, const uint8_t newaddr) {
+    #if ENABLED(I2CPE_ASYNC_READ)
+      finish_read();
+    #endif
+
     // First check 'new' address is not in use
     Wire.beginTransmission(newaddr);
     if (!Wire.endTransmission()) {
@@ -714,6 +982,10 @@
   }
 
   void I2CPositionEncodersMgr::report_module_firmware(const uint8_t address) {
+    #if ENABLED(I2CPE_ASYNC_READ)
+      finish_read();
+    #endif
+
     // First check there is a module
     Wire.beginTransmission(address);
     if (Wire.endTransmission()) {
@@ -1129,4 +1401,86 @@
       report_error(I2CPE_idx);
   }
 
+  #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+
+    void I2CPositionEncodersMgr::measure_ringing(const int8_t idx, const float accel, const float distance, const bool apply) {
+      CHECK_IDX();
+      const AxisEnum axis = encoders[idx].get_axis();
+      float freq, zeta, amplitude;
+
+      // The planner holds the axis to its M201 limit
+      const float used_accel = min(accel, (float)planner.max_acceleration_mm_per_s2[axis]);
+
+      SERIAL_ECHOPAIR("Ringing on ", axis_codes[axis]);
+      if (!encoders[idx].measure_ringing(used_accel, distance, freq, zeta, amplitude)) {
+        SERIAL_ECHOLNPGM(" axis could not be measured.");
+        return;
+      }
+      SERIAL_ECHOPAIR(" axis at ", used_accel);
+      SERIAL_ECHOPAIR("mm/s2: ", freq);
+      SERIAL_ECHOPAIR("Hz, damping ", zeta);
+      SERIAL_ECHOPGM(", amplitude ");
+      SERIAL_ECHO_F(amplitude, 3);
+      SERIAL_ECHOLNPGM("mm.");
+
+      #if ENABLED(INPUT_SHAPING)
+        if (apply && axis <= Y_AXIS) {
+          if (freq < SHAPING_MIN_FREQ) {
+            SERIAL_ECHOLNPGM("Frequency too low for input shaping.");
+            return;
+          }
+          stepper.shaping_frequency[axis] = freq;
+          stepper.shaping_zeta[axis] = min(zeta, 0.5);
+          stepper.refresh_shaping();
+          SERIAL_ECHOLNPGM("Input shaping updated. Please save to EEPROM (M500) if you wish to keep these values.");
+        }
+      #else
+        UNUSED(apply);
+      #endif
+    }
+
+    /**
+     * M870:  Measure the ringing frequency and damping of an axis
+     *        with its position encoder module.
+     *
+     *   A<addr>  Module I2C address.  [30, 200].
+     *   I<index> Module index.  [0, I2CPE_ENCODER_CNT - 1].
+     *   S<accel> Acceleration of the test move, up to the axis M201 limit. Default is the travel acceleration.
+     *   D<mm>    Length of the test move. Default is I2CPE_RINGING_DISTANCE.
+     *   U        Use the result for input shaping. (Requires INPUT_SHAPING)
+     *
+     *   If A or I not specified:
+     *    X       Measure the X axis, if it has an encoder.
+     *    Y       Measure the Y axis, if it has an encoder.
+     *    Z       Measure the Z axis, if it has an encoder.
+     *
+     *   Repeat with different S values to find the highest acceleration
+     *   with an acceptable amplitude.
+     */
+    void I2CPositionEncodersMgr::M870() {
+      if (parse()) return;
+
+      const float accel = parser.seenval('S') ? parser.value_float() : planner.travel_acceleration,
+                  distance = parser.seenval('D') ? parser.value_linear_units() : I2CPE_RINGING_DISTANCE;
+      const bool apply = parser.seen('U');
+
+      if (accel <= 0 || distance <= 0) {
+        SERIAL_PROTOCOLLNPGM("?S and D must be greater than 0.");
+        return;
+      }
+
+      if (I2CPE_idx == 0xFF) {
+        LOOP_XYZ(i) {
+          if (!I2CPE_anyaxis || parser.seen(axis_codes[i])) {
+            const uint8_t idx = idx_from_axis(AxisEnum(i));
+            if ((int8_t)idx >= 0) measure_ringing(idx, accel, distance, apply);
+          }
+        }
+      }
+      else
+        measure_ringing(I2CPE_idx, accel, distance, apply);
+    }
+
+  #endif // I2CPE_RINGING_MEASUREMENT
+
 #endif // I2C_POSITION_ENCODERS
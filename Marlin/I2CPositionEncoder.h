@@ -44,6 +44,9 @@
   #define I2CPE_REBOOT_TIME             5000              // time we wait for an encoder module to reboot
                                                           // after changing address.
 
+  #define I2CPE_BUS_TIMEOUT_MS          5                 // background read is abandoned if the bus stalls this long
+                                                          // for this long (I2CPE_ASYNC_READ)
+
   #define I2CPE_MAG_SIG_GOOD            0
   #define I2CPE_MAG_SIG_MID             1
   #define I2CPE_MAG_SIG_BAD             2
@@ -142,6 +145,13 @@
       int     err[I2CPE_ERR_ARRAY_SIZE] = { 0 };
     #endif
 
+    #if ENABLED(I2CPE_ASYNC_READ)
+      int32_t   sampleCount         = 0,                  // Latest count read in the background
+                sampleSteps         = 0;                  // Stepper position when that read was started
+      millis_t  sampleTime          = 0;
+      bool      sampleFresh         = false;
+    #endif
+
     //float        positionMm; //calculate
 
   public:
@@ -153,6 +163,15 @@
     void set_homed();
 
     int32_t get_raw_count();
+    int32_t decode_count(i2cLong &encoderCount);
+
+    #if ENABLED(I2CPE_ASYNC_READ)
+      FORCE_INLINE bool is_polled() { return initialised && homed && active; }
+      FORCE_INLINE bool has_sample() { return sampleFresh; }
+      FORCE_INLINE void discard_sample() { sampleFresh = false; }
+      void set_sample(i2cLong &encoderCount, const int32_t steps, const millis_t ms);
+      void set_sample_failed(const millis_t ms);
+    #endif
 
     FORCE_INLINE float mm_from_count(const int32_t count) {
       switch (type) {
@@ -176,6 +195,10 @@
 
     bool test_axis(void);
 
+    #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+      bool measure_ringing(const float accel, const float distance, float &freq, float &zeta, float &amplitude);
+    #endif
+
     FORCE_INLINE int get_error_count(void) { return errorCount; }
     FORCE_INLINE void set_error_count(const int newCount) { errorCount = newCount; }
 
@@ -223,12 +246,27 @@
     static bool I2CPE_anyaxis;
     static uint8_t I2CPE_addr, I2CPE_idx;
 
+    #if ENABLED(I2CPE_ASYNC_READ)
+      static uint8_t busState, busIdx, busCount;
+      static i2cLong busData;
+      static int32_t busSteps;
+      static millis_t busStart, busEvent;    // Time the read was requested, and of the last bus event
+      static void bus_step(const bool start);
+    #endif
+
   public:
 
     static void init(void);
 
-    // consider only updating one endoder per call / tick if encoders become too time intensive
-    static void update(void) { LOOP_PE(i) encoders[i].update(); }
+    #if ENABLED(I2CPE_ASYNC_READ)
+      // Only the encoders with a new background reading are checked
+      static void update(void) { LOOP_PE(i) if (encoders[i].has_sample()) encoders[i].update(); }
+      static void poll(void) { bus_step(true); }
+      static void finish_read(void);
+    #else
+      // consider only updating one endoder per call / tick if encoders become too time intensive
+      static void update(void) { LOOP_PE(i) encoders[i].update(); }
+    #endif
 
     static void homed(const AxisEnum axis) {
       LOOP_PE(i)
@@ -260,6 +298,10 @@
       encoders[idx].calibrate_steps_mm(iterations);
     }
 
+    #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+      static void measure_ringing(const int8_t idx, const float accel, const float distance, const bool apply);
+    #endif
+
     static void change_module_address(const uint8_t oldaddr, const uint8_t newaddr);
     static void report_module_firmware(const uint8_t address);
 
@@ -325,6 +367,9 @@
     static void M867();
     static void M868();
     static void M869();
+    #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+      static void M870();
+    #endif
 
     static I2CPositionEncoder encoders[I2CPE_ENCODER_CNT];
   };
@@ -341,6 +386,9 @@
   FORCE_INLINE static void gcode_M867() { I2CPEM.M867(); }
   FORCE_INLINE static void gcode_M868() { I2CPEM.M868(); }
   FORCE_INLINE static void gcode_M869() { I2CPEM.M869(); }
+  #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+    FORCE_INLINE static void gcode_M870() { I2CPEM.M870(); }
+  #endif
 
 #endif //I2C_POSITION_ENCODERS
 #endif //I2CPOSENC_H
@@ -61,6 +61,9 @@ void manage_inactivity(bool ignore_stepper_queue = false);
 
 #if ENABLED(DUAL_X_CARRIAGE) || ENABLED(DUAL_NOZZLE_DUPLICATION_MODE)
   extern bool extruder_duplication_enabled;
+  #if ENABLED(DUAL_X_CARRIAGE)
+    extern bool mirrored_duplication_mode;
+  #endif
 #endif
 
 #if HAS_X2_ENABLE
@@ -200,6 +203,8 @@ bool enqueue_and_echo_command(const char* cmd, bool say_ok=false); // Add a sing
 void enqueue_and_echo_commands_P(const char * const cmd);          // Set one or more commands to be prioritized over the next Serial/SD command.
 void clear_command_queue();
 
+extern uint8_t commands_in_queue;
+
 extern millis_t previous_cmd_ms;
 inline void refresh_cmd_timeout() { previous_cmd_ms = millis(); }
 
@@ -336,6 +341,10 @@ void report_current_position();
 
 #elif IS_SCARA
   void forward_kinematics_SCARA(const float &a, const float &b);
+  #if ENABLED(SCARA_FAST_KINEMATICS)
+    void scara_incremental_ik_reset();
+    void scara_incremental_ik(const float raw[XYZ]);
+  #endif
 #endif
 
 #if ENABLED(G26_MESH_VALIDATION)
@@ -460,6 +469,10 @@ extern uint8_t active_extruder;
 
 #if ENABLED(MIXING_EXTRUDER)
   extern float mixing_factor[MIXING_STEPPERS];
+  #if MIXING_VIRTUAL_TOOLS > 1
+    extern float mixing_virtual_tool_mix[MIXING_VIRTUAL_TOOLS][MIXING_STEPPERS];
+    extern uint8_t selected_vtool;
+  #endif
 #endif
 
 inline void set_current_from_destination() { COPY(current_position, destination); }
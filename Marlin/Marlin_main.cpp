@@ -135,6 +135,7 @@
  * M120 - Enable endstops detection.
  * M121 - Disable endstops detection.
  * M122 - Debug stepper (Requires HAVE_TMC2130)
+ * M123 - Report ISR timing and planner starvation statistics. R to reset them. (Requires ISR_PROFILING)
  * M125 - Save current position and move to filament change position. (Requires PARK_HEAD_ON_PAUSE)
  * M126 - Solenoid Air Valve Open. (Requires BARICUDA)
  * M127 - Solenoid Air Valve Closed. (Requires BARICUDA)
@@ -148,6 +149,7 @@
  * M163 - Set a single proportion for a mixing extruder. (Requires MIXING_EXTRUDER)
  * M164 - Save the mix as a virtual extruder. (Requires MIXING_EXTRUDER and MIXING_VIRTUAL_TOOLS)
  * M165 - Set the proportions for a mixing extruder. Use parameters ABCDHI to set the mixing factors. (Requires MIXING_EXTRUDER)
+ * M166 - Set a gradient mix between two virtual tools over a range of Z. (Requires GRADIENT_MIX)
  * M190 - Sxxx Wait for bed current temp to reach target temp. ** Waits only when heating! **
  *        Rxxx Wait for bed current temp to reach target temp. ** Waits for heating or cooling. **
  * M200 - Set filament diameter, D<diameter>, setting E axis units to cubic. (Use S0 to revert to linear units.)
@@ -201,6 +203,7 @@
  * M502 - Revert to the default "factory settings". ** Does not write them to EEPROM! **
  * M503 - Print the current settings (in memory): "M503 S<verbose>". S0 specifies compact output.
  * M540 - Enable/disable SD card abort on endstop hit: "M540 S<state>". (Requires ABORT_ON_ENDSTOP_HIT_FEATURE_ENABLED)
+ * M593 - Set input shaping: "M593 [X] [Y] F<hz> D<zeta> T<type>". (Requires INPUT_SHAPING)
  * M600 - Pause for filament change: "M600 X<pos> Y<pos> Z<raise> E<first_retract> L<later_retract>". (Requires ADVANCED_PAUSE_FEATURE)
  * M665 - Set delta configurations: "M665 L<diagonal rod> R<delta radius> S<segments/s> A<rod A trim mm> B<rod B trim mm> C<rod C trim mm> I<tower A trim angle> J<tower B trim angle> K<tower C trim angle>" (Requires DELTA)
  * M666 - Set delta endstop adjustment. (Requires DELTA)
@@ -217,6 +220,7 @@
  * M867 - Enable/disable or toggle error correction for position encoder modules.
  * M868 - Report or set position encoder module error correction threshold.
  * M869 - Report position encoder module error.
+ * M870 - Measure axis ringing frequency and damping with position encoder modules. (Requires I2CPE_RINGING_MEASUREMENT)
  * M900 - Get and/or Set advance K factor and WH/D ratio. (Requires LIN_ADVANCE)
  * M906 - Set or get motor current in milliamps using axis codes X, Y, Z, E. Report values if no axis codes given. (Requires HAVE_TMC2130 or HAVE_TMC2208)
  * M907 - Set digital trimpot motor current using axis codes. (Requires a board with digital trimpots)
@@ -314,6 +318,10 @@
   #include "endstop_interrupts.h"
 #endif
 
+#if ENABLED(ISR_PROFILING)
+  #include "isr_profiler.h"
+#endif
+
 #if ENABLED(M100_FREE_MEMORY_WATCHER)
   void gcode_M100();
   void M100_dump_routine(const char * const title, const char *start, const char *end);
@@ -656,7 +664,8 @@ float cartes[XYZ] = { 0 };
 #if ENABLED(MIXING_EXTRUDER)
   float mixing_factor[MIXING_STEPPERS]; // Reciprocal of mix proportion. 0.0 = off, otherwise >= 1.0.
   #if MIXING_VIRTUAL_TOOLS > 1
-    float mixing_virtual_tool_mix[MIXING_VIRTUAL_TOOLS][MIXING_STEPPERS];
+    float mixing_virtual_tool_mix[MIXING_VIRTUAL_TOOLS][MIXING_STEPPERS]; // Initialized by settings.load()
+    uint8_t selected_vtool = 0;
   #endif
 #endif
 
@@ -1250,13 +1259,21 @@ bool get_target_extruder_from_command(const uint16_t code) {
 }
 
 #if ENABLED(DUAL_X_CARRIAGE) || ENABLED(DUAL_NOZZLE_DUPLICATION_MODE)
-  bool extruder_duplication_enabled = false; // Used in Dual X mode 2
+  bool extruder_duplication_enabled = false; // Used in Dual X mode 2 & 3
 #endif
 
 #if ENABLED(DUAL_X_CARRIAGE)
 
+  bool mirrored_duplication_mode = false;     // Used in Dual X mode 3
+
   static DualXMode dual_x_carriage_mode = DEFAULT_DUAL_X_CARRIAGE_MODE;
 
+  // Both carriages print together in Duplication and Mirrored modes
+  FORCE_INLINE static bool dxc_is_duplicating() { return dual_x_carriage_mode >= DXC_DUPLICATION_MODE; }
+
+  // In Mirrored mode T1 moves opposite to T0, reflected about the bed center
+  FORCE_INLINE static float dxc_mirrored_x(const float &x) { return 2 * (X_CENTER) - x; }
+
   static float x_home_pos(const int extruder) {
     if (extruder == 0)
       return base_home_pos(X_AXIS);
@@ -1273,7 +1290,7 @@ bool get_target_extruder_from_command(const uint16_t code) {
   static int x_home_dir(const int extruder) { return extruder ? X2_HOME_DIR : X_HOME_DIR; }
 
   static float inactive_extruder_x_pos = X2_MAX_POS; // used in mode 0 & 1
-  static bool active_extruder_parked = false;        // used in mode 1 & 2
+  static bool active_extruder_parked = false;        // used in mode 1, 2 & 3
   static float raised_parked_position[XYZE];         // used in mode 1
   static millis_t delayed_move_time = 0;             // used in mode 1
   static float duplicate_extruder_x_offset = DEFAULT_DUPLICATION_X_OFFSET; // used in mode 2
@@ -1314,6 +1331,13 @@ bool get_target_extruder_from_command(const uint16_t code) {
           soft_endstop_min[X_AXIS] = base_min_pos(X_AXIS);
           soft_endstop_max[X_AXIS] = min(base_max_pos(X_AXIS), dual_max_x - duplicate_extruder_x_offset);
         }
+        else if (dual_x_carriage_mode == DXC_MIRRORED_MODE) {
+          // In Mirrored Mode, T0 stays left of the bed center so the carriages
+          // never come closer than the minimum spacing, and T1 (its reflection)
+          // never passes X2_MAX_POS or T1's home position
+          soft_endstop_min[X_AXIS] = max(base_min_pos(X_AXIS), dxc_mirrored_x(dual_max_x));
+          soft_endstop_max[X_AXIS] = min(base_max_pos(X_AXIS), (X_CENTER) - 0.5f * (X2_MIN_POS - x_home_pos(0)));
+        }
         else {
           // In other modes, T0 can move from X_MIN_POS to X_MAX_POS
           soft_endstop_min[axis] = base_min_pos(axis);
@@ -1409,7 +1433,7 @@ static void set_axis_is_at_home(const AxisEnum axis) {
   #endif
 
   #if ENABLED(DUAL_X_CARRIAGE)
-    if (axis == X_AXIS && (active_extruder == 1 || dual_x_carriage_mode == DXC_DUPLICATION_MODE)) {
+    if (axis == X_AXIS && (active_extruder == 1 || dxc_is_duplicating())) {
       current_position[X_AXIS] = x_home_pos(active_extruder);
       return;
     }
@@ -2144,6 +2168,8 @@ static void clean_up_after_endstop_or_probe_move() {
     return false;
   }
 
+  static float probe_trigger_z; // Z where the last probe move triggered
+
   /**
    * @brief Used by run_z_probe to do a single Z probe move.
    *
@@ -2166,7 +2192,13 @@ static void clean_up_after_endstop_or_probe_move() {
     #endif
 
     // Move down until probe triggered
+    #if ENABLED(INPUT_SHAPING)
+      stepper.suspend_shaping(true);
+    #endif
     do_blocking_move_to_z(z, MMM_TO_MMS(fr_mm_m));
+    #if ENABLED(INPUT_SHAPING)
+      stepper.suspend_shaping(false);
+    #endif
 
     // Check to see if the probe was triggered
     const bool probe_triggered = TEST(Endstops::endstop_hit_bits,
@@ -2192,6 +2224,12 @@ static void clean_up_after_endstop_or_probe_move() {
     // Get Z where the steppers were interrupted
     set_current_from_steppers_for_axis(Z_AXIS);
 
+    // The probe triggered a little higher, before the steppers stopped
+    probe_trigger_z = current_position[Z_AXIS];
+    #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+      if (probe_triggered) probe_trigger_z -= stepper.triggered_overshoot_mm(Z_AXIS);
+    #endif
+
     // Tell the planner where we actually are
     SYNC_PLAN_POSITION_KINEMATIC();
 
@@ -2223,7 +2261,7 @@ static void clean_up_after_endstop_or_probe_move() {
       // Do a first probe at the fast speed
       if (do_probe_move(-10, Z_PROBE_SPEED_FAST)) return NAN;
 
-      float first_probe_z = current_position[Z_AXIS];
+      float first_probe_z = probe_trigger_z;
 
       #if ENABLED(DEBUG_LEVELING_FEATURE)
         if (DEBUGGING(LEVELING)) SERIAL_ECHOLNPAIR("1st Probe Z:", first_probe_z);
@@ -2256,7 +2294,7 @@ static void clean_up_after_endstop_or_probe_move() {
         if (do_probe_move(-10, Z_PROBE_SPEED_SLOW)) return NAN;
 
     #if MULTIPLE_PROBING > 2
-        probes_total += current_position[Z_AXIS];
+        probes_total += probe_trigger_z;
         if (p > 1) do_blocking_move_to_z(current_position[Z_AXIS] + Z_CLEARANCE_BETWEEN_PROBES, MMM_TO_MMS(Z_PROBE_SPEED_FAST));
       }
     #endif
@@ -2268,7 +2306,7 @@ static void clean_up_after_endstop_or_probe_move() {
 
     #elif MULTIPLE_PROBING == 2
 
-      const float z2 = current_position[Z_AXIS];
+      const float z2 = probe_trigger_z;
 
       #if ENABLED(DEBUG_LEVELING_FEATURE)
         if (DEBUGGING(LEVELING)) {
@@ -2283,7 +2321,7 @@ static void clean_up_after_endstop_or_probe_move() {
     #else
 
       // Return the single probe result
-      return current_position[Z_AXIS];
+      return probe_trigger_z;
 
     #endif
 
@@ -2815,6 +2853,10 @@ static void clean_up_after_endstop_or_probe_move() {
 /**
  * Home an individual linear axis
  */
+#if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+  static float homing_overshoot; // How far the last homing move went past the endstop
+#endif
+
 static void do_homing_move(const AxisEnum axis, const float distance, const float fr_mm_s=0.0) {
 
   #if ENABLED(DEBUG_LEVELING_FEATURE)
@@ -2836,6 +2878,10 @@ static void do_homing_move(const AxisEnum axis, const float distance, const floa
     if (axis == Z_AXIS) probing_pause(true);
   #endif
 
+  #if ENABLED(INPUT_SHAPING)
+    stepper.suspend_shaping(true);
+  #endif
+
   // Tell the planner the axis is at 0
   current_position[axis] = 0;
 
@@ -2852,6 +2898,10 @@ static void do_homing_move(const AxisEnum axis, const float distance, const floa
 
   stepper.synchronize();
 
+  #if ENABLED(INPUT_SHAPING)
+    stepper.suspend_shaping(false);
+  #endif
+
   #if QUIET_PROBING
     if (axis == Z_AXIS) probing_pause(false);
   #endif
@@ -2860,6 +2910,10 @@ static void do_homing_move(const AxisEnum axis, const float distance, const floa
     if (deploy_bltouch) set_bltouch_deployed(false);
   #endif
 
+  #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+    homing_overshoot = Endstops::endstop_hit_bits ? stepper.triggered_overshoot_mm(axis) : 0;
+  #endif
+
   endstops.hit_on_purpose();
 
   #if ENABLED(DEBUG_LEVELING_FEATURE)
@@ -3048,6 +3102,9 @@ static void homeaxis(const AxisEnum axis) {
     // For cartesian/core machines,
     // set the axis to its home position
     set_axis_is_at_home(axis);
+    #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+      current_position[axis] += homing_overshoot; // The axis stopped a little past its endstop
+    #endif
     sync_plan_position();
 
     destination[axis] = current_position[axis];
@@ -3315,6 +3372,39 @@ void gcode_get_destination() {
 #endif // HOST_KEEPALIVE_FEATURE
 
 
+/**
+ * Clamp the destination to the software endstops and drop any E motion
+ * that is too cold or too long. Shared by every path a G0/G1 move takes
+ * to the planner.
+ */
+static void prepare_move_checks() {
+  clamp_to_software_endstops(destination);
+  refresh_cmd_timeout();
+
+  #if ENABLED(PREVENT_COLD_EXTRUSION) || ENABLED(PREVENT_LENGTHY_EXTRUDE)
+
+    if (!DEBUGGING(DRYRUN)) {
+      if (destination[E_AXIS] != current_position[E_AXIS]) {
+        #if ENABLED(PREVENT_COLD_EXTRUSION)
+          if (thermalManager.tooColdToExtrude(active_extruder)) {
+            current_position[E_AXIS] = destination[E_AXIS]; // Behave as if the move really took place, but ignore E part
+            SERIAL_ECHO_START();
+            SERIAL_ECHOLNPGM(MSG_ERR_COLD_EXTRUDE_STOP);
+          }
+        #endif // PREVENT_COLD_EXTRUSION
+        #if ENABLED(PREVENT_LENGTHY_EXTRUDE)
+          if (FABS(destination[E_AXIS] - current_position[E_AXIS]) * planner.e_factor[active_extruder] > (EXTRUDE_MAXLENGTH)) {
+            current_position[E_AXIS] = destination[E_AXIS]; // Behave as if the move really took place, but ignore E part
+            SERIAL_ECHO_START();
+            SERIAL_ECHOLNPGM(MSG_ERR_LONG_EXTRUDE_STOP);
+          }
+        #endif // PREVENT_LENGTHY_EXTRUDE
+      }
+    }
+
+  #endif
+}
+
 /**************************************************
  ***************** GCode Handlers *****************
  **************************************************/
@@ -3325,6 +3415,30 @@ void gcode_get_destination() {
   #define G0_G1_CONDITION true
 #endif
 
+#if ENABLED(MOVE_COALESCING)
+
+  /**
+   * Hand a G0/G1 XYZ move to the planner's coalescing stage so that it may be
+   * merged with the moves before and after it.
+   *
+   * Returns false if the move needs the full prepare_move_to_destination.
+   */
+  inline bool coalesce_move_to_destination() {
+    #if HAS_MESH
+      if (planner.leveling_active) return false;
+    #endif
+    prepare_move_checks();
+    if (current_position[X_AXIS] == destination[X_AXIS]
+      && current_position[Y_AXIS] == destination[Y_AXIS]
+      && current_position[Z_AXIS] == destination[Z_AXIS]
+    ) return false;
+    planner.buffer_line_coalesced(current_position, destination, MMS_SCALED(feedrate_mm_s), active_extruder);
+    set_current_from_destination();
+    return true;
+  }
+
+#endif
+
 /**
  * G0, G1: Coordinated movement of X Y Z E axes
  */
@@ -3353,6 +3467,8 @@ inline void gcode_G0_G1(
 
     #if IS_SCARA
       fast_move ? prepare_uninterpolated_move_to_destination() : prepare_move_to_destination();
+    #elif ENABLED(MOVE_COALESCING)
+      if (!coalesce_move_to_destination()) prepare_move_to_destination();
     #else
       prepare_move_to_destination();
     #endif
@@ -3364,6 +3480,9 @@ inline void gcode_G0_G1(
         #define _MOVE_SYNC parser.seenval('Z')  // Only for Z move
       #endif
       if (_MOVE_SYNC) {
+        #if ENABLED(MOVE_COALESCING)
+          planner.flush_coalesced_line();
+        #endif
         stepper.synchronize();
         SERIAL_ECHOLNPGM(MSG_Z_MOVE_COMP);
       }
@@ -3469,7 +3588,13 @@ inline void gcode_G0_G1(
 void dwell(millis_t time) {
   refresh_cmd_timeout();
   time += previous_cmd_ms;
+  #if ENABLED(ISR_PROFILING)
+    isr_profiler.dwelling = true;
+  #endif
   while (PENDING(millis(), time)) idle();
+  #if ENABLED(ISR_PROFILING)
+    isr_profiler.dwelling = false;
+  #endif
 }
 
 /**
@@ -4005,6 +4130,9 @@ inline void gcode_G28(const bool always_home_all) {
   #if ENABLED(DUAL_X_CARRIAGE) || ENABLED(DUAL_NOZZLE_DUPLICATION_MODE)
     extruder_duplication_enabled = false;
   #endif
+  #if ENABLED(DUAL_X_CARRIAGE)
+    mirrored_duplication_mode = false;
+  #endif
 
   setup_for_endstop_or_probe_move();
   #if ENABLED(DEBUG_LEVELING_FEATURE)
@@ -7577,7 +7705,7 @@ inline void gcode_M104() {
     thermalManager.setTargetHotend(temp, target_extruder);
 
     #if ENABLED(DUAL_X_CARRIAGE)
-      if (dual_x_carriage_mode == DXC_DUPLICATION_MODE && target_extruder == 0)
+      if (dxc_is_duplicating() && target_extruder == 0)
         thermalManager.setTargetHotend(temp ? temp + duplicate_extruder_temp_offset : 0, 1);
     #endif
 
@@ -7734,7 +7862,7 @@ inline void gcode_M109() {
     thermalManager.setTargetHotend(temp, target_extruder);
 
     #if ENABLED(DUAL_X_CARRIAGE)
-      if (dual_x_carriage_mode == DXC_DUPLICATION_MODE && target_extruder == 0)
+      if (dxc_is_duplicating() && target_extruder == 0)
         thermalManager.setTargetHotend(temp ? temp + duplicate_extruder_temp_offset : 0, 1);
     #endif
 
@@ -8578,6 +8706,21 @@ inline void gcode_M120() { endstops.enable_globally(true); }
  */
 inline void gcode_M121() { endstops.enable_globally(false); }
 
+#if ENABLED(ISR_PROFILING)
+
+  /**
+   * M123: Report the stepper and temperature ISR durations, late stepper
+   *       compares, the main loop period, and planner starvation events.
+   *
+   *   R = Reset all statistics after reporting
+   */
+  inline void gcode_M123() {
+    isr_profiler.report();
+    if (parser.seen('R')) isr_profiler.reset();
+  }
+
+#endif // ISR_PROFILING
+
 #if ENABLED(PARK_HEAD_ON_PAUSE)
 
   /**
@@ -9899,6 +10042,52 @@ inline void gcode_M502() {
 
 #endif // ABORT_ON_ENDSTOP_HIT_FEATURE_ENABLED
 
+#if ENABLED(INPUT_SHAPING)
+
+  /**
+   * M593: Set input shaping parameters
+   *
+   *  X / Y      Axes to change (default both)
+   *  F<hz>      Ringing frequency. 0 to disable shaping.
+   *  D<zeta>    Damping ratio (0.0 - 0.5)
+   *  T<type>    Shaper: 0=ZV 1=ZVD 2=MZV
+   *
+   * With no F, D, or T report the current settings.
+   */
+  inline void gcode_M593() {
+    const bool seen_x = parser.seen('X'), seen_y = parser.seen('Y'),
+               for_x = seen_x || !seen_y, for_y = seen_y || !seen_x;
+
+    if (parser.seen('F') || parser.seen('D') || parser.seen('T')) {
+      LOOP_S_LE_N(axis, X_AXIS, Y_AXIS) {
+        if (!(axis == X_AXIS ? for_x : for_y)) continue;
+        if (parser.seen('F')) {
+          const float freq = parser.value_float();
+          if (freq && freq < SHAPING_MIN_FREQ) {
+            SERIAL_ERROR_START();
+            SERIAL_ERRORLNPGM("?F must be 0 or at least " STRINGIFY(SHAPING_MIN_FREQ) ".");
+            return;
+          }
+          stepper.shaping_frequency[axis] = freq;
+        }
+        if (parser.seen('D')) stepper.shaping_zeta[axis] = constrain(parser.value_float(), 0, 0.5);
+        if (parser.seen('T')) stepper.shaping_type[axis] = (ShaperType)constrain(parser.value_int(), SHAPER_ZV, SHAPER_MZV);
+      }
+      stepper.refresh_shaping();
+    }
+
+    LOOP_S_LE_N(axis, X_AXIS, Y_AXIS) {
+      if (!(axis == X_AXIS ? for_x : for_y)) continue;
+      SERIAL_ECHO_START();
+      SERIAL_CHAR(axis_codes[axis]);
+      SERIAL_ECHOPAIR(" Shaping F", stepper.shaping_frequency[axis]);
+      SERIAL_ECHOPAIR(" D", stepper.shaping_zeta[axis]);
+      SERIAL_ECHOLNPAIR(" T", (int)stepper.shaping_type[axis]);
+    }
+  }
+
+#endif // INPUT_SHAPING
+
 #if HAS_BED_PROBE
 
   inline void gcode_M851() {
@@ -10123,6 +10312,9 @@ inline void gcode_M502() {
    *                         units x-offset and an optional differential hotend temperature of
    *                         mmm degrees. E.g., with "M605 S2 X100 R2" the second extruder will duplicate
    *                         the first with a spacing of 100mm in the x direction and 2 degrees hotter.
+   *    M605 S3 [Rmmm]: Mirrored mode. The second extruder will mirror the first about the bed center,
+   *                    stepping in the same pass with its X direction reversed, for symmetric parts.
+   *                    An optional differential hotend temperature is set with R as in Duplication mode.
    *
    *    Note: the X axis should be homed after changing dual x-carriage mode.
    */
@@ -10147,13 +10339,18 @@ inline void gcode_M502() {
         SERIAL_CHAR(',');
         SERIAL_ECHOLN(hotend_offset[Y_AXIS][1]);
         break;
+      case DXC_MIRRORED_MODE:
+        if (parser.seen('R')) duplicate_extruder_temp_offset = parser.value_celsius_diff();
+        break;
       default:
         dual_x_carriage_mode = DEFAULT_DUAL_X_CARRIAGE_MODE;
         break;
     }
     active_extruder_parked = false;
     extruder_duplication_enabled = false;
+    mirrored_duplication_mode = false;
     delayed_move_time = 0;
+    update_software_endstops(X_AXIS);
   }
 
 #elif ENABLED(DUAL_NOZZLE_DUPLICATION_MODE)
@@ -10214,8 +10411,21 @@ inline void gcode_M502() {
     TMC_E1,
     TMC_E2,
     TMC_E3,
-    TMC_E4
+    TMC_E4,
+    TMC_AXES
   };
+  #if ENABLED(MONITOR_DRIVER_STATUS)
+    // Driver state kept by monitor_tmc_driver(), one driver read per call
+    struct TMC_driver_cache {
+      uint16_t sg_average;  // Rolling average of SG_RESULT while moving (TMC2130). Lower is more load.
+      uint8_t otpw_cnt;
+      #if ENABLED(ADAPTIVE_CURRENT)
+        uint8_t irun,       // Run current scale last applied
+                set_irun;   // Run current scale as set by M906
+      #endif
+    };
+    static TMC_driver_cache tmc_cache[TMC_AXES];
+  #endif
   #if ENABLED(TMC_DEBUG)
     enum TMC_debug_enum {
       TMC_CODES,
@@ -10254,6 +10464,7 @@ inline void gcode_M502() {
       TMC_DRV_CS_ACTUAL,
       TMC_FSACTIVE,
       TMC_SG_RESULT,
+      TMC_SG_AVERAGE,
       TMC_DRV_STATUS_HEX,
       TMC_T157,
       TMC_T150,
@@ -10381,6 +10592,9 @@ inline void gcode_M502() {
         case TMC_DRV_OTPW:      if (st.otpw())         SERIAL_ECHOPGM("X"); break;
         case TMC_OT:            if (st.ot())           SERIAL_ECHOPGM("X"); break;
         case TMC_DRV_CS_ACTUAL: MYSERIAL.print(st.cs_actual(), DEC);        break;
+        #if ENABLED(MONITOR_DRIVER_STATUS)
+          case TMC_SG_AVERAGE:  MYSERIAL.print(tmc_cache[axis].sg_average, DEC); break;
+        #endif
         case TMC_DRV_STATUS_HEX:drv_status_print_hex(extended_axis_codes[axis], st.DRV_STATUS()); break;
         default: tmc_parse_drv_status(st, i); break;
       }
@@ -10503,6 +10717,9 @@ inline void gcode_M502() {
         #if ENABLED(HAVE_TMC2130)
           SERIAL_ECHOPGM("stallguard\t");     drv_status_loop(TMC_STALLGUARD);
           SERIAL_ECHOPGM("sg_result\t");      drv_status_loop(TMC_SG_RESULT);
+          #if ENABLED(MONITOR_DRIVER_STATUS)
+            SERIAL_ECHOPGM("sg_average");     drv_status_loop(TMC_SG_AVERAGE);
+          #endif
           SERIAL_ECHOPGM("fsactive\t");       drv_status_loop(TMC_FSACTIVE);
         #endif
         SERIAL_ECHOPGM("stst\t");             drv_status_loop(TMC_STST);
@@ -10988,6 +11205,9 @@ inline void gcode_M355() {
         normalize_mix();
         for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
           mixing_virtual_tool_mix[tool_index][i] = mixing_factor[i];
+        #if ENABLED(GRADIENT_MIX)
+          planner.refresh_gradient();
+        #endif
       }
     }
 
@@ -11010,6 +11230,65 @@ inline void gcode_M355() {
     inline void gcode_M165() { gcode_get_mix(); }
   #endif
 
+  #if ENABLED(GRADIENT_MIX)
+
+    /**
+     * M166: Set a gradient mix between two virtual tools over a range of Z.
+     *       The mix is updated with each move as the layers go up.
+     *
+     *   A[z]       Height where the gradient starts
+     *   Z[z]       Height where the gradient ends
+     *   I[index]   Virtual tool with the mix at the start height
+     *   J[index]   Virtual tool with the mix at the end height
+     *   T[index]   Virtual tool that prints the gradient. Default: the selected tool.
+     *   S[bool]    Turn the gradient on or off
+     *
+     * With no parameters, report the gradient.
+     */
+    inline void gcode_M166() {
+      gradient_t &g = planner.gradient;
+      const bool was_enabled = g.enabled;
+
+      if (parser.seenval('A')) g.start_z = parser.value_linear_units();
+      if (parser.seenval('Z')) g.end_z = parser.value_linear_units();
+      if (parser.seenval('I')) { g.start_vtool = parser.value_byte(); NOMORE(g.start_vtool, MIXING_VIRTUAL_TOOLS - 1); }
+      if (parser.seenval('J')) { g.end_vtool = parser.value_byte(); NOMORE(g.end_vtool, MIXING_VIRTUAL_TOOLS - 1); }
+      if (parser.seenval('T')) { g.vtool_index = parser.value_byte(); NOMORE(g.vtool_index, MIXING_VIRTUAL_TOOLS - 1); }
+      if (parser.seen('S')) {
+        g.enabled = parser.value_bool();
+        if (g.enabled && !parser.seen('T')) g.vtool_index = selected_vtool;
+      }
+
+      // Keep the range going up
+      if (g.end_z < g.start_z) {
+        const float z = g.start_z;
+        g.start_z = g.end_z;
+        g.end_z = z;
+        const uint8_t t = g.start_vtool;
+        g.start_vtool = g.end_vtool;
+        g.end_vtool = t;
+      }
+
+      // Go back to the plain tool mix
+      if (was_enabled && !g.enabled)
+        for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
+          mixing_factor[i] = mixing_virtual_tool_mix[selected_vtool][i];
+
+      planner.refresh_gradient();
+
+      SERIAL_ECHO_START();
+      SERIAL_ECHOPGM("Gradient ");
+      serialprintPGM(g.enabled ? PSTR(MSG_ON) : PSTR(MSG_OFF));
+      SERIAL_ECHOPAIR(" T", g.vtool_index);
+      SERIAL_ECHOPAIR(" A", g.start_z);
+      SERIAL_ECHOPAIR(" (T", g.start_vtool);
+      SERIAL_ECHOPAIR(") Z", g.end_z);
+      SERIAL_ECHOPAIR(" (T", g.end_vtool);
+      SERIAL_ECHOLNPGM(")");
+    }
+
+  #endif // GRADIENT_MIX
+
 #endif // MIXING_EXTRUDER
 
 /**
@@ -11133,6 +11412,11 @@ void tool_change(const uint8_t tmp_extruder, const float fr_mm_s/*=0.0*/, bool n
     for (uint8_t j = 0; j < MIXING_STEPPERS; j++)
       mixing_factor[j] = mixing_virtual_tool_mix[tmp_extruder][j];
 
+    selected_vtool = tmp_extruder;
+    #if ENABLED(GRADIENT_MIX)
+      planner.refresh_gradient();
+    #endif
+
   #else // !MIXING_EXTRUDER || MIXING_VIRTUAL_TOOLS <= 1
 
     if (tmp_extruder >= EXTRUDERS)
@@ -11232,16 +11516,20 @@ void tool_change(const uint8_t tmp_extruder, const float fr_mm_s/*=0.0*/, bool n
               delayed_move_time = 0;
               break;
             case DXC_DUPLICATION_MODE:
+            case DXC_MIRRORED_MODE:
               // If the new extruder is the left one, set it "parked"
               // This triggers the second extruder to move into the duplication position
               active_extruder_parked = (active_extruder == 0);
 
               if (active_extruder_parked)
                 current_position[X_AXIS] = inactive_extruder_x_pos;
+              else if (dual_x_carriage_mode == DXC_MIRRORED_MODE)
+                current_position[X_AXIS] = dxc_mirrored_x(destination[X_AXIS]);
               else
                 current_position[X_AXIS] = destination[X_AXIS] + duplicate_extruder_x_offset;
               inactive_extruder_x_pos = destination[X_AXIS];
               extruder_duplication_enabled = false;
+              mirrored_duplication_mode = false;
               #if ENABLED(DEBUG_LEVELING_FEATURE)
                 if (DEBUGGING(LEVELING)) {
                   SERIAL_ECHOLNPAIR("Set inactive_extruder_x_pos=", inactive_extruder_x_pos);
@@ -11591,6 +11879,11 @@ inline void gcode_T(const uint8_t tmp_extruder) {
 void process_parsed_command() {
   KEEPALIVE_STATE(IN_HANDLER);
 
+  #if ENABLED(MOVE_COALESCING)
+    // Only G0/G1 may continue a held move
+    if (parser.command_letter != 'G' || parser.codenum > 1) planner.flush_coalesced_line();
+  #endif
+
   // Handle a known G, M, or T
   switch (parser.command_letter) {
     case 'G': switch (parser.codenum) {
@@ -11999,6 +12292,12 @@ void process_parsed_command() {
         gcode_M121();
         break;
 
+      #if ENABLED(ISR_PROFILING)
+        case 123: // M123: Report ISR timing statistics
+          gcode_M123();
+          break;
+      #endif
+
       #if ENABLED(ULTIPANEL)
 
         case 145: // M145: Set material heatup parameters
@@ -12035,6 +12334,11 @@ void process_parsed_command() {
             gcode_M165();
             break;
         #endif
+        #if ENABLED(GRADIENT_MIX)
+          case 166: // M166: Set a gradient mix
+            gcode_M166();
+            break;
+        #endif
       #endif
 
       #if DISABLED(NO_VOLUMETRICS)
@@ -12263,6 +12567,12 @@ void process_parsed_command() {
           break;
       #endif
 
+      #if ENABLED(INPUT_SHAPING)
+        case 593: // M593: Set input shaping parameters
+          gcode_M593();
+          break;
+      #endif
+
       #if HAS_BED_PROBE
         case 851: // M851: Set Z Probe Z Offset
           gcode_M851();
@@ -12425,6 +12735,12 @@ void process_parsed_command() {
           gcode_M869();
           break;
 
+        #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+          case 870: // M870 Measure axis ringing
+            gcode_M870();
+            break;
+        #endif
+
       #endif // I2C_POSITION_ENCODERS
 
       case 999: // M999: Restart after being Stopped
@@ -12482,6 +12798,7 @@ void FlushSerialRequestResend() {
  *   N<int>  Line number of the command, if any
  *   P<int>  Planner space remaining
  *   B<int>  Block queue space remaining
+ *   T<int>  Queued motion time in ms (with PLANNER_TIME_WATERMARK)
  */
 void ok_to_send() {
   refresh_cmd_timeout();
@@ -12497,6 +12814,9 @@ void ok_to_send() {
     }
     SERIAL_PROTOCOLPGM(" P"); SERIAL_PROTOCOL(int(BLOCK_BUFFER_SIZE - planner.movesplanned() - 1));
     SERIAL_PROTOCOLPGM(" B"); SERIAL_PROTOCOL(BUFSIZE - commands_in_queue);
+    #if ENABLED(PLANNER_TIME_WATERMARK)
+      SERIAL_PROTOCOLPGM(" T"); SERIAL_PROTOCOL(planner.block_buffer_runtime());
+    #endif
   #endif
   SERIAL_EOL();
 }
@@ -13143,7 +13463,9 @@ void set_current_from_steppers_for_axis(const AxisEnum axis) {
     // gives the number of segments
     uint16_t segments = delta_segments_per_second * seconds;
 
-    // For SCARA minimum segment size is 0.25mm
+    // For SCARA minimum segment size is 0.25mm. SCARA_FAST_KINEMATICS makes
+    // each segment cheaper, but the planner still limits how many can be
+    // queued per second, so the limit stays.
     #if IS_SCARA
       NOMORE(segments, cartesian_mm * 4);
     #endif
@@ -13177,6 +13499,9 @@ void set_current_from_steppers_for_axis(const AxisEnum axis) {
     float raw[XYZE];
     COPY(raw, current_position);
 
+    #if ENABLED(SCARA_FAST_KINEMATICS)
+      scara_incremental_ik_reset();
+    #endif
 
     // Calculate and execute the segments
     while (--segments) {
@@ -13191,6 +13516,8 @@ void set_current_from_steppers_for_axis(const AxisEnum axis) {
       LOOP_XYZE(i) raw[i] += segment_distance[i];
       #if ENABLED(DELTA)
         DELTA_IK(raw); // Delta can inline its kinematics
+      #elif ENABLED(SCARA_FAST_KINEMATICS)
+        scara_incremental_ik(raw); // SCARA steps on from the previous segment
       #else
         inverse_kinematics(raw);
       #endif
@@ -13303,11 +13630,15 @@ void set_current_from_steppers_for_axis(const AxisEnum axis) {
           break;
 
         case DXC_DUPLICATION_MODE:
+        case DXC_MIRRORED_MODE:
           if (active_extruder == 0) {
+            const bool mirrored = dual_x_carriage_mode == DXC_MIRRORED_MODE;
+            const float dup_x = mirrored ? dxc_mirrored_x(current_position[X_AXIS])
+                                         : current_position[X_AXIS] + duplicate_extruder_x_offset;
             #if ENABLED(DEBUG_LEVELING_FEATURE)
               if (DEBUGGING(LEVELING)) {
                 SERIAL_ECHOPAIR("Set planner X", inactive_extruder_x_pos);
-                SERIAL_ECHOLNPAIR(" ... Line to X", current_position[X_AXIS] + duplicate_extruder_x_offset);
+                SERIAL_ECHOLNPAIR(" ... Line to X", dup_x);
               }
             #endif
             // move duplicate extruder into correct duplication position.
@@ -13318,13 +13649,14 @@ void set_current_from_steppers_for_axis(const AxisEnum axis) {
               current_position[E_AXIS]
             );
             planner.buffer_line(
-              current_position[X_AXIS] + duplicate_extruder_x_offset,
+              dup_x,
               current_position[Y_AXIS], current_position[Z_AXIS], current_position[E_AXIS],
               planner.max_feedrate_mm_s[X_AXIS], 1
             );
             SYNC_PLAN_POSITION_KINEMATIC();
             stepper.synchronize();
             extruder_duplication_enabled = true;
+            mirrored_duplication_mode = mirrored;
             active_extruder_parked = false;
             #if ENABLED(DEBUG_LEVELING_FEATURE)
               if (DEBUGGING(LEVELING)) SERIAL_ECHOLNPGM("Set extruder_duplication_enabled\nClear active_extruder_parked");
@@ -13352,32 +13684,16 @@ void set_current_from_steppers_for_axis(const AxisEnum axis) {
  * before calling or cold/lengthy extrusion may get missed.
  */
 void prepare_move_to_destination() {
-  clamp_to_software_endstops(destination);
-  refresh_cmd_timeout();
-
-  #if ENABLED(PREVENT_COLD_EXTRUSION) || ENABLED(PREVENT_LENGTHY_EXTRUDE)
-
-    if (!DEBUGGING(DRYRUN)) {
-      if (destination[E_AXIS] != current_position[E_AXIS]) {
-        #if ENABLED(PREVENT_COLD_EXTRUSION)
-          if (thermalManager.tooColdToExtrude(active_extruder)) {
-            current_position[E_AXIS] = destination[E_AXIS]; // Behave as if the move really took place, but ignore E part
-            SERIAL_ECHO_START();
-            SERIAL_ECHOLNPGM(MSG_ERR_COLD_EXTRUDE_STOP);
-          }
-        #endif // PREVENT_COLD_EXTRUSION
-        #if ENABLED(PREVENT_LENGTHY_EXTRUDE)
-          if (FABS(destination[E_AXIS] - current_position[E_AXIS]) * planner.e_factor[active_extruder] > (EXTRUDE_MAXLENGTH)) {
-            current_position[E_AXIS] = destination[E_AXIS]; // Behave as if the move really took place, but ignore E part
-            SERIAL_ECHO_START();
-            SERIAL_ECHOLNPGM(MSG_ERR_LONG_EXTRUDE_STOP);
-          }
-        #endif // PREVENT_LENGTHY_EXTRUDE
-      }
-    }
+  #if ENABLED(MOVE_COALESCING)
+    planner.flush_coalesced_line();
+  #endif
 
+  #if ENABLED(GRADIENT_MIX)
+    planner.update_gradient_mix(LOGICAL_Z_POSITION(destination[Z_AXIS]));
   #endif
 
+  prepare_move_checks();
+
   #if ENABLED(DUAL_X_CARRIAGE)
     if (dual_x_carriage_unpark()) return;
   #endif
@@ -13710,6 +14026,96 @@ void prepare_move_to_destination() {
     //*/
   }
 
+  #if ENABLED(SCARA_FAST_KINEMATICS)
+
+    // Arm angles (radians) of the last segment, with their sines and cosines
+    static float scara_a, scara_b, scara_a_cos, scara_a_sin, scara_b_cos, scara_b_sin;
+    static uint8_t scara_resync_count = 0;
+
+    /**
+     * Start a new series of segments. The next one gets an exact solution.
+     */
+    void scara_incremental_ik_reset() { scara_resync_count = 0; }
+
+    /**
+     * Rotate a cosine/sine pair by a small angle d (radians).
+     * Third-order Taylor terms keep the error below d^4/24.
+     */
+    FORCE_INLINE static void scara_rotate(float &c, float &s, const float &d) {
+      const float d2 = sq(d),
+                  cd = 1.0f - 0.5f * d2,
+                  sd = d * (1.0f - d2 * (1.0f / 6.0f)),
+                  c0 = c;
+      c = c0 * cd - s * sd;
+      s = s * cd + c0 * sd;
+    }
+
+    /**
+     * Morgan SCARA Inverse Kinematics for consecutive segments. Results in delta[].
+     *
+     * Segments of a move are short, so instead of solving the arm from scratch
+     * take one Newton step from the previous arm angles. The distance from the
+     * arm's current position to the target is mapped through the inverse Jacobian
+     * with a second-order correction, and the sines and cosines of both arms are
+     * carried along by small rotations. No SQRT, ATAN2, sin or cos are needed.
+     *
+     * On 150mm arms the error is under 0.5µm for the shortest 0.25mm segments,
+     * about 1µm for 1mm and 7µm for 2mm, well under one motor step. Longer steps,
+     * poses close to fully stretched or folded, and every
+     * SCARA_FAST_KINEMATICS_RESYNC segments are solved exactly with
+     * inverse_kinematics(). buildroot/share/scripts/checkScaraKinematics.sh
+     * checks this on the host.
+     */
+    void scara_incremental_ik(const float raw[XYZ]) {
+
+      const float sx = raw[X_AXIS] - SCARA_OFFSET_X,
+                  sy = raw[Y_AXIS] - SCARA_OFFSET_Y;
+
+      if (scara_resync_count) {
+        // Distance from the arm's present position to the target
+        const float ex = sx - (L1 * scara_a_cos + L2 * scara_b_cos),
+                    ey = sy - (L1 * scara_a_sin + L2 * scara_b_sin),
+                    // Sine of the elbow angle is the Jacobian determinant / (L1 * L2)
+                    s_elbow = scara_b_sin * scara_a_cos - scara_b_cos * scara_a_sin;
+
+        if (HYPOT2(ex, ey) <= 4.0f && FABS(s_elbow) >= 0.2f) {
+          const float inv_s = 1.0f / s_elbow,
+                      ka = inv_s * (1.0f / (L1)), kb = inv_s * (1.0f / (L2)),
+                      // First-order step through the inverse Jacobian
+                      da1 = (scara_b_cos * ex + scara_b_sin * ey) * ka,
+                      db1 = -(scara_a_cos * ex + scara_a_sin * ey) * kb,
+                      // Aim past the curvature of the arcs that step would miss
+                      qa = 0.5f * (L1) * sq(da1), qb = 0.5f * (L2) * sq(db1),
+                      cx = ex + qa * scara_a_cos + qb * scara_b_cos,
+                      cy = ey + qa * scara_a_sin + qb * scara_b_sin,
+                      da = (scara_b_cos * cx + scara_b_sin * cy) * ka,
+                      db = -(scara_a_cos * cx + scara_a_sin * cy) * kb;
+
+          scara_rotate(scara_a_cos, scara_a_sin, da);
+          scara_rotate(scara_b_cos, scara_b_sin, db);
+          scara_a += da;
+          scara_b += db;
+
+          delta[A_AXIS] = DEGREES(scara_a);
+          delta[B_AXIS] = DEGREES(scara_b);
+          delta[C_AXIS] = raw[Z_AXIS];
+
+          if (++scara_resync_count >= SCARA_FAST_KINEMATICS_RESYNC) scara_resync_count = 0;
+          return;
+        }
+      }
+
+      // Exact solution, reseeding the incremental state
+      inverse_kinematics(raw);
+      scara_a = RADIANS(delta[A_AXIS]);
+      scara_b = RADIANS(delta[B_AXIS]);
+      scara_a_cos = cos(scara_a); scara_a_sin = sin(scara_a);
+      scara_b_cos = cos(scara_b); scara_b_sin = sin(scara_b);
+      scara_resync_count = 1;
+    }
+
+  #endif // SCARA_FAST_KINEMATICS
+
 #endif // MORGAN_SCARA
 
 #if ENABLED(TEMP_STAT_LEDS)
@@ -13827,6 +14233,8 @@ void disable_all_steppers() {
    * Reduce driver current in a persistent otpw condition.
    * Keep track of otpw counter so we don't reduce current on a single instance,
    * and so we don't repeatedly report warning before the condition is cleared.
+   * Drivers are read one at a time, spread over the 500ms interval, so the
+   * main loop never waits on all of them at once.
    */
 
   struct TMC_driver_data {
@@ -13834,6 +14242,8 @@ void disable_all_steppers() {
     bool is_otpw;
     bool is_ot;
     bool is_error;
+    bool has_load;        // sg_result is a valid load reading
+    uint16_t sg_result;
   };
   #if ENABLED(HAVE_TMC2130)
     static uint32_t get_pwm_scale(TMC2130Stepper &st) { return st.PWM_SCALE(); }
@@ -13850,6 +14260,10 @@ void disable_all_steppers() {
       data.is_otpw = (data.drv_status & OTPW_bm)>>OTPW_bp;
       data.is_ot = (data.drv_status & OT_bm)>>OT_bp;
       data.is_error = (st.status_response & DRIVER_ERROR_bm)>>DRIVER_ERROR_bp;
+      constexpr uint32_t STST_bm = 0x80000000UL;
+      constexpr uint16_t SG_RESULT_bm = 0x3FF;
+      data.has_load = !(data.drv_status & STST_bm);  // Only measured while the motor turns
+      data.sg_result = data.drv_status & SG_RESULT_bm;
       return data;
     }
   #endif
@@ -13873,13 +14287,18 @@ void disable_all_steppers() {
       data.is_otpw = (data.drv_status & OTPW_bm)>>OTPW_bp;
       data.is_ot = (data.drv_status & OT_bm)>>OT_bp;
       data.is_error = st.drv_err();
+      data.has_load = false;  // No stallGuard
       return data;
     }
   #endif
 
   template<typename TMC>
-  uint8_t monitor_tmc_driver(TMC &st, const char axisID, uint8_t otpw_cnt) {
+  void monitor_tmc_driver(TMC &st, const AxisEnum axis, TMC_driver_cache &cache) {
+    const char axisID = axis_codes[axis];
     TMC_driver_data data = get_driver_data(st);
+    uint8_t &otpw_cnt = cache.otpw_cnt;
+
+    if (data.has_load) cache.sg_average = (cache.sg_average * 3 + data.sg_result) >> 2;
 
     #if ENABLED(STOP_ON_ERROR)
       if (data.is_error) {
@@ -13942,59 +14361,138 @@ void disable_all_steppers() {
       SERIAL_ECHO("\t");
     }
 
-    return otpw_cnt;
+    #if ENABLED(ADAPTIVE_CURRENT)
+      /**
+       * Step the run current down while the motor is lightly loaded and
+       * go straight back to the set current when the load rises.
+       */
+      const uint8_t irun = st.irun();
+      if (irun != cache.irun) cache.irun = cache.set_irun = irun;  // Changed by M906 or the overtemperature step-down
+      if (data.has_load) {
+        uint8_t new_irun = irun;
+        if (cache.sg_average < ADAPTIVE_CURRENT_SG_LOW)
+          new_irun = cache.set_irun;
+        else if (cache.sg_average > ADAPTIVE_CURRENT_SG_HIGH && irun > (cache.set_irun * (ADAPTIVE_CURRENT_MIN) + 99) / 100)
+          new_irun = irun - 1;
+        if (new_irun != irun) {
+          st.irun(new_irun);
+          cache.irun = new_irun;
+          #if ENABLED(REPORT_CURRENT_CHANGE)
+            SERIAL_ECHO(axisID);
+            SERIAL_ECHOLNPAIR(" run current scale ", new_irun);
+          #endif
+        }
+      }
+    #endif
   }
 
-  void monitor_tmc_driver() {
-    static millis_t next_cOT = 0;
-    if (ELAPSED(millis(), next_cOT)) {
-      next_cOT = millis() + 500;
+  #if ENABLED(ADAPTIVE_CURRENT)
+    template<typename TMC>
+    static void tmc_restore_current(TMC &st, TMC_driver_cache &cache) {
+      if (st.irun() != cache.irun) return;  // M906 got there first
+      st.irun(cache.set_irun);
+      cache.irun = cache.set_irun;
+    }
+  #endif
+
+  /**
+   * Read one driver. Return false if there's no monitored driver in this slot.
+   */
+  static bool monitor_tmc_driver(const TMC_AxisEnum axis, const bool restore=false) {
+    #if ENABLED(ADAPTIVE_CURRENT)
+      #define TMC_MONITOR(A,AXIS) case TMC_##A: \
+        if (restore) tmc_restore_current(stepper##A, tmc_cache[TMC_##A]); \
+        else monitor_tmc_driver(stepper##A, AXIS, tmc_cache[TMC_##A]); \
+        return true
+    #else
+      UNUSED(restore);
+      #define TMC_MONITOR(A,AXIS) case TMC_##A: monitor_tmc_driver(stepper##A, AXIS, tmc_cache[TMC_##A]); return true
+    #endif
+    switch (axis) {
       #if ENABLED(X_IS_TMC2130)|| (ENABLED(X_IS_TMC2208) && defined(X_HARDWARE_SERIAL)) || ENABLED(IS_TRAMS)
-        static uint8_t x_otpw_cnt = 0;
-        x_otpw_cnt = monitor_tmc_driver(stepperX, axis_codes[X_AXIS], x_otpw_cnt);
-      #endif
-      #if ENABLED(Y_IS_TMC2130)|| (ENABLED(Y_IS_TMC2208) && defined(Y_HARDWARE_SERIAL)) || ENABLED(IS_TRAMS)
-        static uint8_t y_otpw_cnt = 0;
-        y_otpw_cnt = monitor_tmc_driver(stepperY, axis_codes[Y_AXIS], y_otpw_cnt);
-      #endif
-      #if ENABLED(Z_IS_TMC2130)|| (ENABLED(Z_IS_TMC2208) && defined(Z_HARDWARE_SERIAL)) || ENABLED(IS_TRAMS)
-        static uint8_t z_otpw_cnt = 0;
-        z_otpw_cnt = monitor_tmc_driver(stepperZ, axis_codes[Z_AXIS], z_otpw_cnt);
+        TMC_MONITOR(X, X_AXIS);
       #endif
       #if ENABLED(X2_IS_TMC2130) || (ENABLED(X2_IS_TMC2208) && defined(X2_HARDWARE_SERIAL))
-        static uint8_t x2_otpw_cnt = 0;
-        x2_otpw_cnt = monitor_tmc_driver(stepperX2, axis_codes[X_AXIS], x2_otpw_cnt);
+        TMC_MONITOR(X2, X_AXIS);
+      #endif
+      #if ENABLED(Y_IS_TMC2130)|| (ENABLED(Y_IS_TMC2208) && defined(Y_HARDWARE_SERIAL)) || ENABLED(IS_TRAMS)
+        TMC_MONITOR(Y, Y_AXIS);
       #endif
       #if ENABLED(Y2_IS_TMC2130) || (ENABLED(Y2_IS_TMC2208) && defined(Y2_HARDWARE_SERIAL))
-        static uint8_t y2_otpw_cnt = 0;
-        y2_otpw_cnt = monitor_tmc_driver(stepperY2, axis_codes[Y_AXIS], y2_otpw_cnt);
+        TMC_MONITOR(Y2, Y_AXIS);
+      #endif
+      #if ENABLED(Z_IS_TMC2130)|| (ENABLED(Z_IS_TMC2208) && defined(Z_HARDWARE_SERIAL)) || ENABLED(IS_TRAMS)
+        TMC_MONITOR(Z, Z_AXIS);
       #endif
       #if ENABLED(Z2_IS_TMC2130) || (ENABLED(Z2_IS_TMC2208) && defined(Z2_HARDWARE_SERIAL))
-        static uint8_t z2_otpw_cnt = 0;
-        z2_otpw_cnt = monitor_tmc_driver(stepperZ2, axis_codes[Z_AXIS], z2_otpw_cnt);
+        TMC_MONITOR(Z2, Z_AXIS);
       #endif
       #if ENABLED(E0_IS_TMC2130)|| (ENABLED(E0_IS_TMC2208) && defined(E0_HARDWARE_SERIAL)) || ENABLED(IS_TRAMS)
-        static uint8_t e0_otpw_cnt = 0;
-        e0_otpw_cnt = monitor_tmc_driver(stepperE0, axis_codes[E_AXIS], e0_otpw_cnt);
+        TMC_MONITOR(E0, E_AXIS);
       #endif
       #if ENABLED(E1_IS_TMC2130) || (ENABLED(E1_IS_TMC2208) && defined(E1_HARDWARE_SERIAL))
-        static uint8_t e1_otpw_cnt = 0;
-        e1_otpw_cnt = monitor_tmc_driver(stepperE1, axis_codes[E_AXIS], e1_otpw_cnt);
+        TMC_MONITOR(E1, E_AXIS);
       #endif
       #if ENABLED(E2_IS_TMC2130) || (ENABLED(E2_IS_TMC2208) && defined(E2_HARDWARE_SERIAL))
-        static uint8_t e2_otpw_cnt = 0;
-        e2_otpw_cnt = monitor_tmc_driver(stepperE2, axis_codes[E_AXIS], e2_otpw_cnt);
+        TMC_MONITOR(E2, E_AXIS);
       #endif
       #if ENABLED(E3_IS_TMC2130) || (ENABLED(E3_IS_TMC2208) && defined(E3_HARDWARE_SERIAL))
-        static uint8_t e3_otpw_cnt = 0;
-        e3_otpw_cnt = monitor_tmc_driver(stepperE3, axis_codes[E_AXIS], e3_otpw_cnt);
+        TMC_MONITOR(E3, E_AXIS);
       #endif
       #if ENABLED(E4_IS_TMC2130) || (ENABLED(E4_IS_TMC2208) && defined(E4_HARDWARE_SERIAL))
-        static uint8_t e4_otpw_cnt = 0;
-        e4_otpw_cnt = monitor_tmc_driver(stepperE4, axis_codes[E_AXIS], e4_otpw_cnt);
+        TMC_MONITOR(E4, E_AXIS);
       #endif
+      default: return false;
+    }
+    #undef TMC_MONITOR
+  }
+
+  #if ENABLED(ADAPTIVE_CURRENT)
+    /**
+     * Look through the blocks queued since the last call. A hard acceleration
+     * gets full run current back on the drivers it moves before it starts.
+     */
+    static void tmc_check_planner() {
+      static uint8_t block_index = 0;
+      static const AxisEnum tmc_axis[TMC_AXES] = { X_AXIS, X_AXIS, Y_AXIS, Y_AXIS, Z_AXIS, Z_AXIS, E_AXIS, E_AXIS, E_AXIS, E_AXIS, E_AXIS };
+      const uint8_t head = planner.block_buffer_head;
+      uint8_t axis_bits = 0;
+      for (; block_index != head; block_index = BLOCK_MOD(block_index + 1)) {
+        const block_t * const block = &planner.block_buffer[block_index];
+        if (block->acceleration >= ADAPTIVE_CURRENT_ACCEL)
+          LOOP_XYZE(i) if (block->steps[i]) SBI(axis_bits, i);
+      }
+      if (axis_bits) LOOP_L_N(i, TMC_AXES)
+        if (TEST(axis_bits, tmc_axis[i]) && tmc_cache[i].irun != tmc_cache[i].set_irun)
+          monitor_tmc_driver((TMC_AxisEnum)i, true);
+    }
+  #endif
 
-      if (report_tmc_status) SERIAL_EOL();
+  /**
+   * Read the next driver in turn. The number of drivers found in the
+   * last round sets the spacing, so each is still read every 500ms.
+   */
+  void monitor_tmc_driver() {
+    #if ENABLED(ADAPTIVE_CURRENT)
+      tmc_check_planner();
+    #endif
+    static millis_t next_cOT = 0;
+    static uint8_t axis = 0, found = 0;
+    static uint16_t spacing = 500;
+    const millis_t ms = millis();
+    if (ELAPSED(ms, next_cOT)) {
+      next_cOT = ms + spacing;
+      for (uint8_t tries = TMC_AXES; tries--;) {
+        const bool polled = monitor_tmc_driver((TMC_AxisEnum)axis);
+        if (polled) found++;
+        if (++axis == TMC_AXES) {
+          axis = 0;
+          if (found) spacing = 500 / found;
+          found = 0;
+          if (report_tmc_status) SERIAL_EOL();
+        }
+        if (polled) break;
+      }
     }
   }
 
@@ -14213,11 +14711,18 @@ void idle(
     print_job_timer.tick();
   #endif
 
+  #if ENABLED(SD_GCODE_CACHE)
+    card.gcode_cache_task();
+  #endif
+
   #if HAS_BUZZER && DISABLED(LCD_USE_I2C_BUZZER)
     buzzer.tick();
   #endif
 
   #if ENABLED(I2C_POSITION_ENCODERS)
+    #if ENABLED(I2CPE_ASYNC_READ)
+      I2CPEM.poll();
+    #endif
     if (planner.blocks_queued() &&
         ( (blockBufferIndexRef != planner.block_buffer_head) ||
           ((lastUpdateMillis + I2CPE_MIN_UPD_TIME_MS) < millis())) ) {
@@ -14478,18 +14983,6 @@ void setup() {
   #endif
 
   #if ENABLED(MIXING_EXTRUDER) && MIXING_VIRTUAL_TOOLS > 1
-    // Virtual Tools 0, 1, 2, 3 = Filament 1, 2, 3, 4, etc.
-    for (uint8_t t = 0; t < MIXING_VIRTUAL_TOOLS && t < MIXING_STEPPERS; t++)
-      for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
-        mixing_virtual_tool_mix[t][i] = (t == i) ? 1.0 : 0.0;
-
-    // Remaining virtual tools are 100% filament 1
-    #if MIXING_STEPPERS < MIXING_VIRTUAL_TOOLS
-      for (uint8_t t = MIXING_STEPPERS; t < MIXING_VIRTUAL_TOOLS; t++)
-        for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
-          mixing_virtual_tool_mix[t][i] = (i == 0) ? 1.0 : 0.0;
-    #endif
-
     // Initialize mixing to tool 0 color
     for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
       mixing_factor[i] = mixing_virtual_tool_mix[0][i];
@@ -14551,6 +15044,10 @@ void setup() {
  *  - Call LCD update
  */
 void loop() {
+  #if ENABLED(ISR_PROFILING)
+    isr_profiler.loop_tick();
+  #endif
+
   if (commands_in_queue < BUFSIZE) get_available_commands();
 
   #if ENABLED(SDSUPPORT)
@@ -14603,5 +15100,24 @@ void loop() {
     }
   }
   endstops.report_state();
+
+  #if ENABLED(MOVE_COALESCING)
+    // Don't hold a move back while the planner runs out of work
+    if (planner.movesplanned() < (BLOCK_BUFFER_SIZE) / 4) planner.flush_coalesced_line();
+  #endif
+
+  #if ENABLED(PLANNER_TIME_WATERMARK)
+    // While the planner is short of queued motion hand it the next command
+    // before the idle tasks. The less time is queued, the longer idle() may
+    // wait, up to a quarter of the target. Once the target is reached (long
+    // segments) idle() runs on every pass.
+    static millis_t last_idle_ms = 0;
+    if (commands_in_queue && planner.needs_moves()) {
+      const uint16_t queued_ms = planner.block_buffer_runtime();
+      if (millis() - last_idle_ms < ((PLANNER_TARGET_QUEUE_MS) - queued_ms) / 4) return;
+    }
+    last_idle_ms = millis();
+  #endif
+
   idle();
 }
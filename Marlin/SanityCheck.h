@@ -346,6 +346,8 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
     #elif ENABLED(SDSORT_CACHE_NAMES)
       #error "SDSORT_CACHE_NAMES requires SDSORT_USES_RAM (which reads the directory into RAM)."
     #endif
+  #elif ENABLED(SDSORT_INDEX_FILE)
+    #error "SDSORT_INDEX_FILE keeps names on the SD card. Disable SDSORT_USES_RAM to use it."
   #endif
 
   #if ENABLED(SDSORT_CACHE_NAMES) && DISABLED(SDSORT_DYNAMIC_RAM)
@@ -367,6 +369,12 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
     #error "I2C_POSITION_ENCODERS requires BABYSTEPPING."
   #elif !WITHIN(I2CPE_ENCODER_CNT, 1, 5)
     #error "I2CPE_ENCODER_CNT must be between 1 and 5."
+  #elif ENABLED(I2CPE_RINGING_MEASUREMENT) && !WITHIN(I2CPE_RINGING_SAMPLES, 32, 1000)
+    #error "I2CPE_RINGING_SAMPLES must be between 32 and 1000."
+  #elif ENABLED(I2CPE_ASYNC_READ) && (ENABLED(EXPERIMENTAL_I2CBUS) || ENABLED(DAC_STEPPER_CURRENT) || ENABLED(DIGIPOT_I2C) \
+        || ENABLED(PCA9632) || ENABLED(BLINKM) || defined(LCD_I2C_ADDRESS) || ENABLED(LCM1602) \
+        || ENABLED(U8GLIB_SSD1306) || ENABLED(U8GLIB_SH1106))
+    #error "I2CPE_ASYNC_READ requires the encoders to be the only devices on the I2C bus."
   #endif
 #endif
 
@@ -386,6 +394,8 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
     #error "BABYSTEP_ZPROBE_GFX_OVERLAY requires a DOGLCD."
   #elif ENABLED(BABYSTEP_ZPROBE_GFX_OVERLAY) && !ENABLED(BABYSTEP_ZPROBE_OFFSET)
     #error "BABYSTEP_ZPROBE_GFX_OVERLAY requires a BABYSTEP_ZPROBE_OFFSET."
+  #elif !WITHIN(BABYSTEP_MAX_RATE, (F_CPU) / 8 / 65535 + 1, (F_CPU) / 8 / 200)
+    #error "BABYSTEP_MAX_RATE must be between 31 and 10000 steps/s (at 16MHz)."
   #endif
 #endif
 
@@ -497,12 +507,44 @@ static_assert(X_MAX_LENGTH >= X_BED_SIZE && Y_MAX_LENGTH >= Y_BED_SIZE,
   #elif ENABLED(LIN_ADVANCE)
     #error "MIXING_EXTRUDER is incompatible with LIN_ADVANCE."
   #endif
+  #if ENABLED(GRADIENT_MIX)
+    #if MIXING_VIRTUAL_TOOLS < 2
+      #error "GRADIENT_MIX requires MIXING_VIRTUAL_TOOLS >= 2."
+    #endif
+  #endif
+#elif ENABLED(GRADIENT_MIX)
+  #error "GRADIENT_MIX requires MIXING_EXTRUDER."
 #endif
 
 #if ENABLED(LIN_ADVANCE) && !IS_CARTESIAN
   #error "Sorry! LIN_ADVANCE is only compatible with Cartesian."
 #endif
 
+/**
+ * Input Shaping requirements
+ */
+#if ENABLED(INPUT_SHAPING)
+  #if IS_KINEMATIC
+    #error "INPUT_SHAPING is incompatible with DELTA and SCARA."
+  #elif IS_CORE
+    #error "INPUT_SHAPING is incompatible with COREXY, COREXZ, COREYZ, and their reverses."
+  #elif ENABLED(DUAL_X_CARRIAGE)
+    #error "INPUT_SHAPING is incompatible with DUAL_X_CARRIAGE."
+  #elif ENABLED(X_DUAL_ENDSTOPS) || ENABLED(Y_DUAL_ENDSTOPS)
+    #error "INPUT_SHAPING is incompatible with X_DUAL_ENDSTOPS and Y_DUAL_ENDSTOPS."
+  #elif !defined(SHAPING_FREQ_X) || !defined(SHAPING_FREQ_Y) || !defined(SHAPING_ZETA_X) || !defined(SHAPING_ZETA_Y)
+    #error "INPUT_SHAPING requires SHAPING_FREQ_[XY] and SHAPING_ZETA_[XY]."
+  #elif !defined(SHAPING_TYPE_X) || !defined(SHAPING_TYPE_Y)
+    #error "INPUT_SHAPING requires SHAPING_TYPE_X and SHAPING_TYPE_Y."
+  #elif SHAPING_MIN_FREQ < 1
+    #error "SHAPING_MIN_FREQ must be at least 1."
+  #elif !WITHIN(SHAPING_BUFFER_SIZE, 4, 256) || (SHAPING_BUFFER_SIZE & (SHAPING_BUFFER_SIZE - 1))
+    #error "SHAPING_BUFFER_SIZE must be a power of 2 from 4 to 256."
+  #endif
+  static_assert(!(SHAPING_FREQ_X) || (SHAPING_FREQ_X) >= (SHAPING_MIN_FREQ), "SHAPING_FREQ_X must be 0 or at least SHAPING_MIN_FREQ.");
+  static_assert(!(SHAPING_FREQ_Y) || (SHAPING_FREQ_Y) >= (SHAPING_MIN_FREQ), "SHAPING_FREQ_Y must be 0 or at least SHAPING_MIN_FREQ.");
+#endif
+
 /**
  * Parking Extruder requirements
  */
@@ -628,6 +670,17 @@ static_assert(1 >= 0
   #endif
 #endif
 
+/**
+ * SCARA requirements
+ */
+#if ENABLED(SCARA_FAST_KINEMATICS)
+  #if DISABLED(MORGAN_SCARA)
+    #error "SCARA_FAST_KINEMATICS requires MORGAN_SCARA."
+  #elif !WITHIN(SCARA_FAST_KINEMATICS_RESYNC, 2, 255)
+    #error "SCARA_FAST_KINEMATICS_RESYNC must be between 2 and 255."
+  #endif
+#endif
+
 /**
  * Probes
  */
@@ -1482,6 +1535,23 @@ static_assert(1 >= 0
   #error "Enable STEALTHCHOP to use HYBRID_THRESHOLD."
 #endif
 
+/**
+ * Adaptive current
+ */
+#if ENABLED(ADAPTIVE_CURRENT)
+  #if DISABLED(HAVE_TMC2130)
+    #error "ADAPTIVE_CURRENT requires TMC2130 stepper drivers."
+  #elif DISABLED(MONITOR_DRIVER_STATUS)
+    #error "ADAPTIVE_CURRENT requires MONITOR_DRIVER_STATUS."
+  #elif !WITHIN(ADAPTIVE_CURRENT_MIN, 10, 100)
+    #error "ADAPTIVE_CURRENT_MIN must be between 10 and 100."
+  #elif ADAPTIVE_CURRENT_SG_LOW >= ADAPTIVE_CURRENT_SG_HIGH
+    #error "ADAPTIVE_CURRENT_SG_LOW must be less than ADAPTIVE_CURRENT_SG_HIGH."
+  #elif ADAPTIVE_CURRENT_ACCEL <= DEFAULT_ACCELERATION
+    #error "ADAPTIVE_CURRENT_ACCEL must be above DEFAULT_ACCELERATION, or every print move restores the full current."
+  #endif
+#endif
+
 /**
  * Make sure HAVE_L6470DRIVER is warranted
  */
@@ -1611,4 +1681,12 @@ static_assert(COUNT(sanity_arr_3) <= XYZE_N, "DEFAULT_MAX_ACCELERATION has too m
   #endif
 #endif
 
+#if ENABLED(MOVE_COALESCING)
+  #if IS_KINEMATIC
+    #error "MOVE_COALESCING is only compatible with Cartesian and Core machines."
+  #elif ENABLED(DUAL_X_CARRIAGE)
+    #error "MOVE_COALESCING is incompatible with DUAL_X_CARRIAGE."
+  #endif
+#endif
+
 #endif // _SANITYCHECK_H_
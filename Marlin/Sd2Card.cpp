@@ -67,8 +67,9 @@
     SPDR = 0xFF;
     for (uint16_t i = 0; i < nbyte; i++) {
       while (!TEST(SPSR, SPIF)) { /* Intentionally left empty */ }
-      buf[i] = SPDR;
-      SPDR = 0xFF;
+      const uint8_t b = SPDR;
+      SPDR = 0xFF;  // Start the next byte before storing this one
+      buf[i] = b;
     }
     while (!TEST(SPSR, SPIF)) { /* Intentionally left empty */ }
     buf[nbyte] = SPDR;
@@ -165,6 +166,21 @@
 
 // send command and return error code.  Return zero for OK
 uint8_t Sd2Card::cardCommand(uint8_t cmd, uint32_t arg) {
+  #if ENABLED(SD_MULTIBLOCK_READ)
+    // Any other command ends a multiple block read
+    if (inReadStream_) {
+      inReadStream_ = false;
+      readStop();
+    }
+  #endif
+  #if ENABLED(SD_BUFFERED_WRITE)
+    // ...as does a multiple block write
+    if (inWriteStream_) {
+      inWriteStream_ = false;
+      writeStop();
+    }
+  #endif
+
   // select card
   chipSelectLow();
 
@@ -299,6 +315,14 @@ bool Sd2Card::eraseSingleBlockEnable() {
  */
 bool Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
   errorCode_ = type_ = 0;
+  #if ENABLED(SD_MULTIBLOCK_READ)
+    inReadStream_ = false;
+    nextBlock_ = 0;
+  #endif
+  #if ENABLED(SD_BUFFERED_WRITE)
+    inWriteStream_ = false;
+    nextWriteBlock_ = 0;
+  #endif
   chipSelectPin_ = chipSelectPin;
   // 16-bit init start time allows over a minute
   uint16_t t0 = (uint16_t)millis();
@@ -394,6 +418,18 @@ bool Sd2Card::init(uint8_t sckRateID, uint8_t chipSelectPin) {
  * \return true for success, false for failure.
  */
 bool Sd2Card::readBlock(uint32_t blockNumber, uint8_t* dst) {
+
+  #if ENABLED(SD_MULTIBLOCK_READ)
+    // Read sequential blocks with CMD18, saving a command per block.
+    // Other reads fall through to CMD17, which ends the sequence.
+    const bool sequential = (blockNumber == nextBlock_);
+    nextBlock_ = blockNumber + 1;
+    if (sequential) {
+      if (!inReadStream_) inReadStream_ = readStart(blockNumber);
+      if (inReadStream_ && readData(dst)) return true;
+    }
+  #endif
+
   // use address if not SDHC card
   if (type() != SD_CARD_TYPE_SDHC) blockNumber <<= 9;
 
@@ -606,6 +642,19 @@ bool Sd2Card::waitNotBusy(uint16_t timeoutMillis) {
  * \return true for success, false for failure.
  */
 bool Sd2Card::writeBlock(uint32_t blockNumber, const uint8_t* src) {
+
+  #if ENABLED(SD_BUFFERED_WRITE)
+    // Write sequential blocks with CMD25 so the card programs each block
+    // while the next is gathered, instead of waiting on every block.
+    // Other writes fall through to CMD24, which ends the sequence.
+    const bool sequential = (blockNumber == nextWriteBlock_);
+    nextWriteBlock_ = blockNumber + 1;
+    if (sequential) {
+      if (!inWriteStream_) inWriteStream_ = writeStart(blockNumber, 1);
+      if (inWriteStream_ && writeData(src)) return true;
+    }
+  #endif
+
   // use address if not SDHC card
   if (type() != SD_CARD_TYPE_SDHC) blockNumber <<= 9;
   if (cardCommand(CMD24, blockNumber)) {
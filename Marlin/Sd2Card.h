@@ -185,6 +185,15 @@ class Sd2Card {
           status_,
           type_;
 
+  #if ENABLED(SD_MULTIBLOCK_READ)
+    bool inReadStream_;   // A CMD18 read is in progress
+    uint32_t nextBlock_;  // Block that continues the current read
+  #endif
+  #if ENABLED(SD_BUFFERED_WRITE)
+    bool inWriteStream_;      // A CMD25 write is in progress
+    uint32_t nextWriteBlock_; // Block that continues the current write
+  #endif
+
   // private functions
   uint8_t cardAcmd(uint8_t cmd, uint32_t arg) {
     cardCommand(CMD55, 0);
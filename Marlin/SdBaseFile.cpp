@@ -295,6 +295,22 @@ void SdBaseFile::getpos(filepos_t* pos) {
   pos->cluster = curCluster_;
 }
 
+/**
+ * Set the hidden attribute in a file's directory entry.
+ *
+ * \return true for success, false for failure.
+ */
+bool SdBaseFile::hide() {
+  if (!isFile()) return false;
+
+  // cache entry
+  dir_t* d = cacheDirEntry(SdVolume::CACHE_FOR_WRITE);
+  if (!d) return false;
+
+  d->attributes |= DIR_ATT_HIDDEN;
+  return vol_->cacheFlush();
+}
+
 /**
  * List directory contents.
  *
@@ -1051,7 +1067,6 @@ int16_t SdBaseFile::read(void* buf, uint16_t nbyte) {
  * a directory file or an I/O error occurred.
  */
 int8_t SdBaseFile::readDir(dir_t* dir, char* longFilename) {
-  int16_t n;
   // if not a directory file or miss-positioned return an error
   if (!isDir() || (0x1F & curPosition_)) return -1;
 
@@ -1060,34 +1075,49 @@ int8_t SdBaseFile::readDir(dir_t* dir, char* longFilename) {
 
   while (1) {
 
-    n = read(dir, sizeof(dir_t));
-    if (n != sizeof(dir_t)) return n ? -1 : 0;
-
-    // last entry if DIR_NAME_FREE
-    if (dir->name[0] == DIR_NAME_FREE) return 0;
-
-    // skip empty entries and entry for .  and ..
-    if (dir->name[0] == DIR_NAME_DELETED || dir->name[0] == '.') continue;
-
-    // Fill the long filename if we have a long filename entry.
-    // Long filename entries are stored before the short filename.
-    if (longFilename != NULL && DIR_IS_LONG_NAME(dir)) {
-      vfat_t* VFAT = (vfat_t*)dir;
-      // Sanity-check the VFAT entry. The first cluster is always set to zero. And the sequence number should be higher than 0
-      if (VFAT->firstClusterLow == 0) {
-        const uint8_t seq = VFAT->sequenceNumber & 0x1F;
-        if (WITHIN(seq, 1, MAX_VFAT_ENTRIES)) {
-          // TODO: Store the filename checksum to verify if a long-filename-unaware system modified the file table.
-          n = (seq - 1) * (FILENAME_LENGTH);
-          for (uint8_t i = 0; i < FILENAME_LENGTH; i++)
-            longFilename[n + i] = (i < 5) ? VFAT->name1[i] : (i < 11) ? VFAT->name2[i - 5] : VFAT->name3[i - 11];
-          // If this VFAT entry is the last one, add a NUL terminator at the end of the string
-          if (VFAT->sequenceNumber & 0x40) longFilename[n + FILENAME_LENGTH] = '\0';
+    // Cache the block holding the next entry
+    dir_t* p = readDirCache();
+    if (!p) return curPosition_ < fileSize_ ? -1 : 0;
+
+    // Work through the rest of the cached block in place,
+    // copying out only the entry that will be returned.
+    for (;;) {
+
+      // last entry if DIR_NAME_FREE
+      if (p->name[0] == DIR_NAME_FREE) return 0;
+
+      // skip empty entries and entry for .  and ..
+      if (p->name[0] != DIR_NAME_DELETED && p->name[0] != '.') {
+
+        // Fill the long filename if we have a long filename entry.
+        // Long filename entries are stored before the short filename.
+        if (longFilename != NULL && DIR_IS_LONG_NAME(p)) {
+          vfat_t* VFAT = (vfat_t*)p;
+          // Sanity-check the VFAT entry. The first cluster is always set to zero. And the sequence number should be higher than 0
+          if (VFAT->firstClusterLow == 0) {
+            const uint8_t seq = VFAT->sequenceNumber & 0x1F;
+            if (WITHIN(seq, 1, MAX_VFAT_ENTRIES)) {
+              // TODO: Store the filename checksum to verify if a long-filename-unaware system modified the file table.
+              const uint8_t n = (seq - 1) * (FILENAME_LENGTH);
+              for (uint8_t i = 0; i < FILENAME_LENGTH; i++)
+                longFilename[n + i] = (i < 5) ? VFAT->name1[i] : (i < 11) ? VFAT->name2[i - 5] : VFAT->name3[i - 11];
+              // If this VFAT entry is the last one, add a NUL terminator at the end of the string
+              if (VFAT->sequenceNumber & 0x40) longFilename[n + FILENAME_LENGTH] = '\0';
+            }
+          }
+        }
+        // Return if normal file or subdirectory
+        if (DIR_IS_FILE_OR_SUBDIR(p)) {
+          memcpy(dir, p, sizeof(dir_t));
+          return sizeof(dir_t);
         }
       }
+
+      // Stop at the end of the block or directory
+      if (!(curPosition_ & 0x1FF) || curPosition_ >= fileSize_) break;
+      p++;
+      curPosition_ += sizeof(dir_t);
     }
-    // Return if normal file or subdirectory
-    if (DIR_IS_FILE_OR_SUBDIR(dir)) return n;
   }
 }
 
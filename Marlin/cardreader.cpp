@@ -28,6 +28,7 @@
 
 #include "ultralcd.h"
 #include "stepper.h"
+#include "temperature.h"
 #include "language.h"
 
 #define LONGEST_FILENAME (longFilename[0] ? longFilename : filename)
@@ -35,6 +36,9 @@
 CardReader::CardReader() {
   #if ENABLED(SDCARD_SORT_ALPHA)
     sort_count = 0;
+    #if ENABLED(SDSORT_INDEX_FILE)
+      sortIndexCount = 0;
+    #endif
     #if ENABLED(SDSORT_GCODE)
       sort_alpha = true;
       sort_folders = FOLDER_SORTING;
@@ -45,6 +49,12 @@ CardReader::CardReader() {
   filesize = 0;
   sdpos = 0;
   file_subcall_ctr = 0;
+  #if ENABLED(SD_GCODE_CACHE)
+    cache_building = cache_reading = false;
+  #endif
+  #if ENABLED(SD_BUFFERED_WRITE)
+    writeBufferLen = 0;
+  #endif
 
   workDirDepth = 0;
   ZERO(workDirParents);
@@ -71,6 +81,17 @@ char *createFilename(char *buffer, const dir_t &p) { //buffer > 12characters
   return buffer;
 }
 
+/**
+ * Test whether a directory entry is listed: a visible folder or G-code file
+ */
+static bool is_dir_or_gcode(const dir_t &p, const char * const lfn) {
+  const uint8_t pn0 = p.name[0];
+  if (pn0 == DIR_NAME_DELETED || pn0 == '.') return false;
+  if (lfn[0] == '.') return false;
+  if (!DIR_IS_FILE_OR_SUBDIR(&p) || (p.attributes & DIR_ATT_HIDDEN)) return false;
+  return DIR_IS_SUBDIR(&p) || (p.name[8] == 'G' && p.name[9] != '~');
+}
+
 /**
  * Dive into a folder and recurse depth-first to perform a pre-set operation lsAction:
  *   LS_Count       - Add +1 to nrFiles for every file within the parent
@@ -80,7 +101,7 @@ char *createFilename(char *buffer, const dir_t &p) { //buffer > 12characters
 
 uint16_t nrFile_index;
 
-void CardReader::lsDive(const char *prepend, SdFile parent, const char * const match/*=NULL*/) {
+void CardReader::lsDive(const char *prepend, SdFile &parent, const char * const match/*=NULL*/) {
   dir_t p;
   uint8_t cnt = 0;
 
@@ -108,10 +129,11 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
 
       // Serial.print(path);
 
-      // Get a new directory object using the full path
-      // and dive recursively into it.
+      // Open the folder by its index in the parent, which is the
+      // entry just read, rather than searching the parent by name.
+      // Then dive recursively into it.
       SdFile dir;
-      if (!dir.open(parent, lfilename, O_READ)) {
+      if (!dir.open(&parent, parent.curPosition() / sizeof(dir_t) - 1, O_READ)) {
         if (lsAction == LS_SerialPrint) {
           SERIAL_ECHO_START();
           SERIAL_ECHOPGM(MSG_SD_CANT_OPEN_SUBDIR);
@@ -122,17 +144,11 @@ void CardReader::lsDive(const char *prepend, SdFile parent, const char * const m
       // close() is done automatically by destructor of SdFile
     }
     else {
-      uint8_t pn0 = p.name[0];
-      if (pn0 == DIR_NAME_FREE) break;
-      if (pn0 == DIR_NAME_DELETED || pn0 == '.') continue;
-      if (longFilename[0] == '.') continue;
-
-      if (!DIR_IS_FILE_OR_SUBDIR(&p) || (p.attributes & DIR_ATT_HIDDEN)) continue;
+      if (p.name[0] == DIR_NAME_FREE) break;
+      if (!is_dir_or_gcode(p, longFilename)) continue;
 
       filenameIsDir = DIR_IS_SUBDIR(&p);
 
-      if (!filenameIsDir && (p.name[8] != 'G' || p.name[9] == '~')) continue;
-
       switch (lsAction) {  // 1 based file count
         case LS_Count:
           nrFiles++;
@@ -276,6 +292,11 @@ void CardReader::setroot() {
 void CardReader::release() {
   sdprinting = false;
   cardOK = false;
+  #if ENABLED(SD_GCODE_CACHE)
+    // Forget the unfinished copy. Its invalid header keeps it from being used.
+    cache_building = false;
+    cacheSrc = cacheOut = SdFile();
+  #endif
 }
 
 void CardReader::openAndPrintFile(const char *name) {
@@ -298,6 +319,9 @@ void CardReader::startFileprint() {
 void CardReader::stopSDPrint() {
   sdprinting = false;
   if (isFileOpen()) file.close();
+  #if ENABLED(SD_GCODE_CACHE)
+    cache_reading = false;
+  #endif
 }
 
 void CardReader::openLogFile(char* name) {
@@ -319,7 +343,14 @@ void CardReader::getAbsFilename(char *t) {
     appendAtom(workDirParents[i], t, cnt);
 
   if (cnt < MAXPATHNAMELENGTH - (FILENAME_LENGTH)) {
-    appendAtom(file, t, cnt);
+    #if ENABLED(SD_GCODE_CACHE)
+      if (cache_reading) {                                  // Name the source, not the copy
+        strcpy(t, cacheName);
+        t += strlen(t) + 1;
+      }
+      else
+    #endif
+        appendAtom(file, t, cnt);
     --t;
   }
   *t = '\0';
@@ -370,6 +401,9 @@ void CardReader::openFile(char* name, const bool read, const bool subcall/*=fals
   }
 
   stopSDPrint();
+  #if ENABLED(SD_GCODE_CACHE)
+    abort_gcode_cache();
+  #endif
 
   SdFile myDir;
   curDir = &root;
@@ -414,6 +448,9 @@ void CardReader::openFile(char* name, const bool read, const bool subcall/*=fals
     if (file.open(curDir, fname, O_READ)) {
       filesize = file.fileSize();
       sdpos = 0;
+      #if ENABLED(SD_GCODE_CACHE)
+        open_gcode_cache(curDir, fname); // Print from the compact copy, if possible
+      #endif
       SERIAL_PROTOCOLPAIR(MSG_SD_FILE_OPENED, fname);
       SERIAL_PROTOCOLLNPAIR(MSG_SD_SIZE, filesize);
       SERIAL_PROTOCOLLNPGM(MSG_SD_FILE_SELECTED);
@@ -434,16 +471,237 @@ void CardReader::openFile(char* name, const bool read, const bool subcall/*=fals
     }
     else {
       saving = true;
+      #if ENABLED(SD_BUFFERED_WRITE)
+        writeBufferLen = 0;
+      #endif
       SERIAL_PROTOCOLLNPAIR(MSG_SD_WRITE_TO_FILE, name);
       lcd_setstatus(fname);
     }
   }
 }
 
+#if ENABLED(SD_GCODE_CACHE)
+
+  /**
+   * Compact a line of G-code in place: drop the line number, checksum and
+   * surrounding spaces. G-codes only take numeric arguments, so they also
+   * lose inner spaces and trailing fractional zeros, e.g. "G1X10Y2.5".
+   */
+  static void compact_gcode_line(char *s) {
+    char *r = s, *w = s;
+    while (*r == ' ') r++;
+    if (*r == 'N' && NUMERIC_SIGNED(r[1])) {
+      r += 2;
+      while (NUMERIC(*r)) r++;
+      while (*r == ' ') r++;
+    }
+    const bool is_g = (*r == 'G') && strncmp_P(r, PSTR("G53"), 3); // G53 chains by spaces
+    for (char c; (c = *r++) && c != '*';) {
+      if (is_g && c == ' ') continue;
+      *w++ = c;
+      if (is_g && c == '.') {
+        while (NUMERIC(*r)) *w++ = *r++;
+        while (w[-1] == '0') --w;
+        if (w[-1] == '.') --w;
+      }
+    }
+    while (w > s && w[-1] == ' ') --w;
+    *w = '\0';
+  }
+
+  /**
+   * The first line of a compact copy identifies its source by size, date
+   * and first cluster. Return the header length, or 0 on failure.
+   */
+  static uint8_t gcode_cache_header(SdFile &src, char *header) {
+    dir_t d;
+    if (!src.dirEntry(&d)) return 0;
+    return sprintf_P(header, PSTR(";MCC2 %08lX %04X%04X %08lX\n"),
+      (unsigned long)src.fileSize(), d.lastWriteDate, d.lastWriteTime, (unsigned long)src.firstCluster());
+  }
+
+  /**
+   * Swap the open G-code file for its hidden compact copy (NAME.MCC) in the
+   * same folder, if the copy is up to date. Otherwise print the source and
+   * start a new copy, to be built by gcode_cache_task() from idle().
+   */
+  bool CardReader::open_gcode_cache(SdFile *dir, const char * const fname) {
+    cacheDir = *dir;
+    strncpy(cacheName, fname, FILENAME_LENGTH - 1);
+    cacheName[FILENAME_LENGTH - 1] = '\0';
+
+    char cname[FILENAME_LENGTH], header[40];
+    uint8_t i = 0;
+    for (; i < 8 && fname[i] && fname[i] != '.'; i++) cname[i] = fname[i];
+    strcpy_P(&cname[i], PSTR(".MCC"));
+
+    const uint8_t hlen = gcode_cache_header(file, header);
+    if (!hlen) return false;
+
+    // Use an existing copy if it matches the source
+    SdFile cache;
+    if (cache.open(dir, cname, O_READ)) {
+      char buf[sizeof(header)];
+      const bool ok = cache.read(buf, hlen) == hlen && !memcmp(buf, header, hlen);
+      cache.close();
+      if (ok) {
+        file.close();
+        if (file.open(dir, cname, O_READ) && file.seekSet(hlen)) {
+          cache_reading = true;
+          cache_src_next = 0;
+          return true;
+        }
+        file.close();
+        file.open(dir, fname, O_READ); // Fall back on the source
+        return false;
+      }
+    }
+
+    // Start a new copy, with a header that's only made valid at the end
+    if (saving || !cacheSrc.open(dir, fname, O_READ)) return false;
+    if (!cacheOut.open(dir, cname, O_CREAT | O_WRITE | O_TRUNC)) {
+      cacheSrc.close();
+      return false;
+    }
+    cacheOut.hide();
+    header[1] = '-';
+    if (cacheOut.write(header, hlen) != hlen) {
+      cacheSrc.close();
+      if (!cacheOut.remove()) cacheOut.close();
+      return false;
+    }
+
+    SERIAL_ECHO_START();
+    SERIAL_ECHOLNPAIR(MSG_SD_CACHING, fname);
+    cacheLineLen = 0;
+    cache_comment = false;
+    cache_pending = 0;
+    next_cache_ms = millis();
+    cache_building = true;
+    return false;
+  }
+
+  /**
+   * Stop building the compact copy and delete it
+   */
+  void CardReader::abort_gcode_cache() {
+    if (!cache_building) return;
+    cache_building = false;
+    cacheSrc.close();
+    if (!cacheOut.remove()) cacheOut.close();
+  }
+
+  /**
+   * Source bytes left out of the copy are recorded as 0x01 followed by a
+   * 16-bit count, so positions read from the copy map back to the source.
+   */
+  bool CardReader::write_cache_skip(uint32_t count) {
+    while (count) {
+      const uint16_t n = count > 0xFFFF ? 0xFFFF : count;
+      const uint8_t rec[3] = { 0x01, uint8_t(n & 0xFF), uint8_t(n >> 8) };
+      if (cacheOut.write(rec, 3) != 3) return false;
+      count -= n;
+    }
+    return true;
+  }
+
+  /**
+   * Compact the next block of the source file into the copy. While printing
+   * this runs at most every 100ms, so the copy takes a few minutes per MB.
+   */
+  void CardReader::gcode_cache_task() {
+    if (!cache_building) return;
+
+    const millis_t ms = millis();
+    if (sdprinting) {
+      if (PENDING(ms, next_cache_ms)) return;
+      next_cache_ms = ms + 100UL;
+    }
+
+    // Split lines the same way as get_sdcard_commands()
+    bool ok = true, done = false;
+    do {
+      const int16_t n = cacheSrc.read();
+      const char c = (char)n;
+      if (n < 0 || c == '\n' || c == '\r' || ((c == '#' || c == ':') && !cache_comment)) {
+        cacheLine[cacheLineLen] = '\0';
+        compact_gcode_line(cacheLine);
+        const uint8_t len = strlen(cacheLine);
+        if (len) {
+          // Text, dropped bytes, then the terminator at its source position
+          cacheLine[len] = c == '#' ? '#' : '\n';
+          ok = cacheOut.write(cacheLine, len) == len
+            && write_cache_skip(cache_pending - len)
+            && cacheOut.write(&cacheLine[len], 1) == 1;
+          cache_pending = 0;
+        }
+        else if (n >= 0)
+          cache_pending++;
+        cacheLineLen = 0;
+        cache_comment = false;
+
+        if (n < 0) {
+          char header[40];
+          const uint8_t hlen = gcode_cache_header(cacheSrc, header);
+          ok = ok && hlen && cacheSrc.curPosition() == cacheSrc.fileSize()
+            && write_cache_skip(cache_pending)
+            && cacheOut.seekSet(0) && cacheOut.write(header, hlen) == hlen && cacheOut.sync();
+          done = true;
+          break;
+        }
+      }
+      else {
+        cache_pending++;
+        if (c != 0x01 && cacheLineLen < MAX_CMD_SIZE - 1) {
+          if (c == ';') cache_comment = true;
+          if (!cache_comment) cacheLine[cacheLineLen++] = c;
+        }
+      }
+    } while (ok && (cacheSrc.curPosition() & 0x1FF));
+
+    if (!ok)
+      abort_gcode_cache();
+    else if (done) {
+      cache_building = false;
+      cacheSrc.close();
+      cacheOut.close();
+    }
+  }
+
+  /**
+   * Read from the compact copy, following skip records so that sdpos is
+   * always the matching offset in the source file. A short copy ends the
+   * print instead of reading on.
+   */
+  int16_t CardReader::get_cached() {
+    int16_t n;
+    while ((n = file.read()) == 0x01) {
+      uint8_t rec[2];
+      if (file.read(rec, 2) != 2) { n = -1; break; }
+      cache_src_next += rec[0] | (uint16_t)rec[1] << 8;
+    }
+    sdpos = n < 0 ? filesize : cache_src_next++;
+    return n;
+  }
+
+  /**
+   * Go back to reading the source file, e.g. to seek with M26
+   */
+  void CardReader::uncache_file() {
+    cache_reading = false;
+    file.close();
+    file.open(&cacheDir, cacheName, O_READ);
+  }
+
+#endif // SD_GCODE_CACHE
+
 void CardReader::removeFile(const char * const name) {
   if (!cardOK) return;
 
   stopSDPrint();
+  #if ENABLED(SD_GCODE_CACHE)
+    abort_gcode_cache();
+  #endif
 
   SdFile myDir;
   curDir = &root;
@@ -519,13 +777,35 @@ void CardReader::write_command(char *buf) {
   end[1] = '\r';
   end[2] = '\n';
   end[3] = '\0';
-  file.write(begin);
+  #if ENABLED(SD_BUFFERED_WRITE)
+    // Fill the buffer up to the next block boundary, then write it out.
+    // Once aligned, whole blocks bypass the volume cache.
+    const char *c = begin;
+    while (*c) {
+      const uint16_t room = 512 - (file.curPosition() & 0x1FF);
+      while (*c && writeBufferLen < room) writeBuffer[writeBufferLen++] = *c++;
+      if (writeBufferLen == room) flush_write_buffer();
+    }
+  #else
+    file.write(begin);
+  #endif
   if (file.writeError) {
     SERIAL_ERROR_START();
     SERIAL_ERRORLNPGM(MSG_SD_ERR_WRITE_TO_FILE);
   }
 }
 
+#if ENABLED(SD_BUFFERED_WRITE)
+
+  void CardReader::flush_write_buffer() {
+    if (writeBufferLen) {
+      file.write(writeBuffer, writeBufferLen);
+      writeBufferLen = 0;
+    }
+  }
+
+#endif
+
 void CardReader::checkautostart(bool force) {
   if (!force && (!autostart_stilltocheck || PENDING(millis(), next_autostart_ms)))
     return;
@@ -560,10 +840,20 @@ void CardReader::checkautostart(bool force) {
 }
 
 void CardReader::closefile(bool store_location) {
+  #if ENABLED(SD_BUFFERED_WRITE)
+    if (saving) flush_write_buffer();
+  #endif
   file.sync();
   file.close();
+  #if ENABLED(SDSORT_INDEX_FILE)
+    const bool was_saving = saving;
+  #endif
   saving = logging = false;
 
+  #if ENABLED(SDSORT_INDEX_FILE)
+    if (was_saving) presort(); // Re-check the index for the new file
+  #endif
+
   if (store_location) {
     //future: store printer state, filename and position for continuing a stopped print
     // so one can unplug the printer and continue printing the next day.
@@ -588,6 +878,9 @@ void CardReader::getfilename(uint16_t nr, const char * const match/*=NULL*/) {
       return;
     }
   #endif // SDSORT_CACHE_NAMES
+  #if ENABLED(SDSORT_INDEX_FILE)
+    if (match == NULL && read_sort_index(nr)) return;
+  #endif
   curDir = &workDir;
   lsAction = LS_GetFilename;
   nrFile_index = nr;
@@ -650,6 +943,165 @@ int8_t CardReader::updir() {
     );
   }
 
+  #if ENABLED(SDSORT_INDEX_FILE)
+
+    /**
+     * The hidden index file in each folder holds a header, the sort order
+     * for the first SDSORT_LIMIT items, and a record for every listed item
+     * in directory order. It's valid while the hash of the folder's entries
+     * (names, dates, sizes and long names) is unchanged.
+     */
+    #define SORT_INDEX_FILENAME "SDSORT.IDX"
+    #define SORT_INDEX_MAGIC    0x3149534DUL // "MSI1"
+
+    typedef struct {
+      uint32_t magic,         // Only written once the index is complete
+               signature;     // Hash of the listed entries
+      uint16_t count,         // Number of listed entries
+               limit;         // SDSORT_LIMIT used to build the index
+      int8_t folders;         // Folder sorting used to build the index
+      uint8_t record_size;    // Changes with MAX_VFAT_ENTRIES
+    } sort_index_header_t;
+
+    typedef struct {
+      char filename[FILENAME_LENGTH];
+      bool isDir;
+      char longFilename[LONG_FILENAME_LENGTH];
+    } sort_index_record_t;
+
+    #define SORT_INDEX_RECORD_POS(I) (sizeof(sort_index_header_t) + (SDSORT_LIMIT) + uint32_t(I) * sizeof(sort_index_record_t))
+
+    #if ENABLED(SDSORT_GCODE)
+      #define SORT_FOLDERS sort_folders
+    #else
+      #define SORT_FOLDERS FOLDER_SORTING
+    #endif
+
+    static uint32_t sort_index_hash(uint32_t h, const uint8_t *data, uint8_t len) {
+      while (len--) h = (h ^ *data++) * 16777619UL; // FNV-1a
+      return h;
+    }
+
+    // True if record a belongs after record b
+    static bool sort_index_after(const sort_index_record_t &a, const sort_index_record_t &b, const int8_t folders) {
+      if (folders && a.isDir != b.isDir) return folders > 0 ? a.isDir : b.isDir;
+      return strcasecmp(a.longFilename[0] ? a.longFilename : a.filename,
+                        b.longFilename[0] ? b.longFilename : b.filename) > 0;
+    }
+
+    /**
+     * Open the index for the current folder and load its sort order,
+     * rebuilding the index first if the folder has changed.
+     * Return false to fall back on sorting without an index.
+     */
+    bool CardReader::load_sort_index() {
+      // Hash the listed entries in a single pass over the folder
+      dir_t p;
+      uint16_t count = 0;
+      uint32_t signature = 2166136261UL;
+      workDir.rewind();
+      while (workDir.readDir(p, longFilename) > 0) {
+        if (p.name[0] == DIR_NAME_FREE) break;
+        if (!is_dir_or_gcode(p, longFilename)) continue;
+        signature = sort_index_hash(signature, p.name, sizeof(p.name));
+        // lastWriteTime, lastWriteDate, firstClusterLow and fileSize
+        signature = sort_index_hash(signature, (const uint8_t*)&p.lastWriteTime, sizeof(dir_t) - offsetof(dir_t, lastWriteTime));
+        signature = sort_index_hash(signature, (const uint8_t*)longFilename, strlen(longFilename));
+        count++;
+      }
+
+      const int8_t folders = SORT_FOLDERS;
+      const uint16_t fileCnt = min(count, uint16_t(SDSORT_LIMIT));
+      sort_index_header_t hdr;
+
+      if (sortIndex.open(&workDir, SORT_INDEX_FILENAME, O_READ)) {
+        if (sortIndex.read(&hdr, sizeof(hdr)) == sizeof(hdr)
+          && hdr.magic == SORT_INDEX_MAGIC && hdr.signature == signature
+          && hdr.count == count && hdr.limit == SDSORT_LIMIT && hdr.folders == folders
+          && hdr.record_size == sizeof(sort_index_record_t)
+          && sortIndex.read(sort_order, fileCnt) == int16_t(fileCnt)
+        ) {
+          sort_count = fileCnt;
+          sortIndexCount = count;
+          return true;
+        }
+        sortIndex.close();
+      }
+
+      // Don't write to the card during a print or upload
+      if (sdprinting || saving) return false;
+
+      if (!sortIndex.open(&workDir, SORT_INDEX_FILENAME, O_CREAT | O_RDWR | O_TRUNC)) return false;
+      sortIndex.hide();
+
+      // Reserve the header and sort order. The header is written last so an
+      // interrupted build is never used.
+      memset(&hdr, 0, sizeof(hdr));
+      bool ok = sortIndex.write(&hdr, sizeof(hdr)) == sizeof(hdr)
+             && sortIndex.write(sort_order, SDSORT_LIMIT) == SDSORT_LIMIT;
+
+      // Append a record per entry and insert the first SDSORT_LIMIT into the
+      // sort order with a binary search over the records already written.
+      sort_index_record_t rec, cmp;
+      uint16_t i = 0;
+      workDir.rewind();
+      while (ok && i < count && workDir.readDir(p, rec.longFilename) > 0) {
+        if (p.name[0] == DIR_NAME_FREE) break;
+        if (!is_dir_or_gcode(p, rec.longFilename)) continue;
+        createFilename(rec.filename, p);
+        rec.isDir = DIR_IS_SUBDIR(&p);
+        ok = sortIndex.seekSet(SORT_INDEX_RECORD_POS(i)) && sortIndex.write(&rec, sizeof(rec)) == sizeof(rec);
+        if (ok && i < fileCnt) {
+          uint16_t lo = 0, hi = i;
+          while (ok && lo < hi) {
+            const uint16_t mid = (lo + hi) >> 1;
+            ok = sortIndex.seekSet(SORT_INDEX_RECORD_POS(sort_order[mid])) && sortIndex.read(&cmp, sizeof(cmp)) == sizeof(cmp);
+            if (sort_index_after(cmp, rec, folders)) hi = mid; else lo = mid + 1;
+          }
+          for (uint16_t j = i; j > lo; --j) sort_order[j] = sort_order[j - 1];
+          sort_order[lo] = i;
+        }
+        i++;
+      }
+
+      if (ok && i == count) {
+        hdr.magic = SORT_INDEX_MAGIC;
+        hdr.signature = signature;
+        hdr.count = count;
+        hdr.limit = SDSORT_LIMIT;
+        hdr.folders = folders;
+        hdr.record_size = sizeof(sort_index_record_t);
+        ok = sortIndex.seekSet(0)
+          && sortIndex.write(&hdr, sizeof(hdr)) == sizeof(hdr)
+          && sortIndex.write(sort_order, fileCnt) == int16_t(fileCnt)
+          && sortIndex.sync();
+        if (ok) {
+          sort_count = fileCnt;
+          sortIndexCount = count;
+          return true;
+        }
+      }
+
+      // Drop a failed index and sort the slow way
+      if (!sortIndex.remove()) sortIndex.close();
+      return false;
+    }
+
+    /**
+     * Get the name of a file from the index by directory order
+     */
+    bool CardReader::read_sort_index(const uint16_t nr) {
+      if (!sortIndex.isOpen() || nr >= sortIndexCount) return false;
+      sort_index_record_t rec;
+      if (!sortIndex.seekSet(SORT_INDEX_RECORD_POS(nr)) || sortIndex.read(&rec, sizeof(rec)) != sizeof(rec)) return false;
+      strcpy(filename, rec.filename);
+      strcpy(longFilename, rec.longFilename);
+      filenameIsDir = rec.isDir;
+      return true;
+    }
+
+  #endif // SDSORT_INDEX_FILE
+
   /**
    * Read all the files and produce a sort key
    *
@@ -668,6 +1120,11 @@ int8_t CardReader::updir() {
     // Throw away old sort index
     flush_presort();
 
+    // Use the on-card index if it matches the directory, or rebuild it
+    #if ENABLED(SDSORT_INDEX_FILE)
+      if (load_sort_index()) return;
+    #endif
+
     // If there are files, sort up to the limit
     uint16_t fileCnt = getnrfilenames();
     if (fileCnt > 0) {
@@ -852,6 +1309,10 @@ int8_t CardReader::updir() {
   }
 
   void CardReader::flush_presort() {
+    #if ENABLED(SDSORT_INDEX_FILE)
+      if (sortIndex.isOpen()) sortIndex.close();
+      sortIndexCount = 0;
+    #endif
     if (sort_count > 0) {
       #if ENABLED(SDSORT_DYNAMIC_RAM)
         delete sort_order;
@@ -874,6 +1335,8 @@ uint16_t CardReader::get_num_Files() {
   return
     #if ENABLED(SDCARD_SORT_ALPHA) && SDSORT_USES_RAM && SDSORT_CACHE_NAMES
       nrFiles // no need to access the SD card for filenames
+    #elif ENABLED(SDCARD_SORT_ALPHA) && SDSORT_INDEX_FILE
+      sortIndex.isOpen() ? sortIndexCount : getnrfilenames()
     #else
       getnrfilenames()
     #endif
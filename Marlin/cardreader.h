@@ -56,6 +56,10 @@ public:
   void getStatus();
   void printingHasFinished();
 
+  #if ENABLED(SD_GCODE_CACHE)
+    void gcode_cache_task();
+  #endif
+
   #if ENABLED(LONG_FILENAME_HOST_SUPPORT)
     void printLongPath(char *path);
   #endif
@@ -85,8 +89,18 @@ public:
   FORCE_INLINE void pauseSDPrint() { sdprinting = false; }
   FORCE_INLINE bool isFileOpen() { return file.isOpen(); }
   FORCE_INLINE bool eof() { return sdpos >= filesize; }
-  FORCE_INLINE int16_t get() { sdpos = file.curPosition(); return (int16_t)file.read(); }
-  FORCE_INLINE void setIndex(long index) { sdpos = index; file.seekSet(index); }
+  FORCE_INLINE int16_t get() {
+    #if ENABLED(SD_GCODE_CACHE)
+      if (cache_reading) return get_cached();
+    #endif
+    sdpos = file.curPosition(); return (int16_t)file.read();
+  }
+  FORCE_INLINE void setIndex(long index) {
+    #if ENABLED(SD_GCODE_CACHE)
+      if (cache_reading) uncache_file(); // Positions refer to the source file
+    #endif
+    sdpos = index; file.seekSet(index);
+  }
   FORCE_INLINE uint8_t percentDone() { return (isFileOpen() && filesize) ? sdpos / ((filesize + 99) / 100) : 0; }
   FORCE_INLINE char* getWorkDirName() { workDir.getFilename(filename); return filename; }
 
@@ -146,6 +160,14 @@ private:
 
     #endif // SDSORT_USES_RAM
 
+    // Hidden on-card index of the current directory
+    #if ENABLED(SDSORT_INDEX_FILE)
+      SdFile sortIndex;
+      uint16_t sortIndexCount;  // Count of all entries in the open index
+      bool load_sort_index();
+      bool read_sort_index(const uint16_t nr);
+    #endif
+
   #endif // SDCARD_SORT_ALPHA
 
   Sd2Card card;
@@ -162,10 +184,34 @@ private:
   millis_t next_autostart_ms;
   bool autostart_stilltocheck; //the sd start is delayed, because otherwise the serial cannot answer fast enought to make contact with the hostsoftware.
 
+  #if ENABLED(SD_GCODE_CACHE)
+    SdFile cacheDir, cacheSrc, cacheOut;  // Folder of the open file, and the source and copy being compacted
+    char cacheName[FILENAME_LENGTH];      // Short name of the open source file
+    char cacheLine[MAX_CMD_SIZE];         // Source line being compacted
+    uint8_t cacheLineLen;
+    bool cache_building, cache_comment, cache_reading;
+    uint32_t cache_pending,               // Source bytes not yet accounted for in the copy
+             cache_src_next;              // Source offset of the next byte read from the copy
+    millis_t next_cache_ms;
+    bool open_gcode_cache(SdFile *dir, const char * const fname);
+    void abort_gcode_cache();
+    bool write_cache_skip(uint32_t count);
+    void uncache_file();
+    int16_t get_cached();
+  #endif
+
   LsAction lsAction; //stored for recursion.
   uint16_t nrFiles; //counter for the files in the current directory and recycled as position counter for getting the nrFiles'th name in the directory.
   char* diveDirName;
-  void lsDive(const char *prepend, SdFile parent, const char * const match=NULL);
+
+  // Lines written by M28 and M928 are gathered into whole blocks
+  #if ENABLED(SD_BUFFERED_WRITE)
+    uint8_t writeBuffer[512];
+    uint16_t writeBufferLen;
+    void flush_write_buffer();
+  #endif
+
+  void lsDive(const char *prepend, SdFile &parent, const char * const match=NULL);
 
   #if ENABLED(SDCARD_SORT_ALPHA)
     void flush_presort();
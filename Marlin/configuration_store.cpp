@@ -36,7 +36,7 @@
  *
  */
 
-#define EEPROM_VERSION "V47"
+#define EEPROM_VERSION "V49"
 
 // Change EEPROM version if these are changed:
 #define EEPROM_OFFSET 100
@@ -175,8 +175,24 @@
  *  718  M852 J    planner.xz_skew_factor           (float)
  *  722  M852 K    planner.yz_skew_factor           (float)
  *
- *  726                                   Minimum end-point
- * 2255 (726 + 208 + 36 + 9 + 288 + 988)  Maximum end-point
+ * INPUT_SHAPING:                                   18 bytes
+ *  726  M593 XY F stepper.shaping_frequency        (float x 2)
+ *  734  M593 XY D stepper.shaping_zeta             (float x 2)
+ *  742  M593 XY T stepper.shaping_type             (ShaperType x 2)
+ *
+ * GRADIENT_MIX:                                    12 bytes
+ *  744  M166 S    planner.gradient.enabled         (bool)
+ *  745  M166 I    planner.gradient.start_vtool     (uint8_t)
+ *  746  M166 J    planner.gradient.end_vtool       (uint8_t)
+ *  747  M166 T    planner.gradient.vtool_index     (uint8_t)
+ *  748  M166 A    planner.gradient.start_z         (float)
+ *  752  M166 Z    planner.gradient.end_z           (float)
+ *
+ * MIXING_EXTRUDER (MIXING_VIRTUAL_TOOLS > 1):      4 bytes x MIXING_VIRTUAL_TOOLS x MIXING_STEPPERS
+ *  756  M164 S    mixing_virtual_tool_mix          (float x 16 x 6, max)
+ *
+ *  756                                         Minimum end-point
+ * 2669 (756 + 208 + 36 + 9 + 288 + 988 + 384)  Maximum end-point
  *
  * ========================================================================
  * meshes_begin (between max and min end-point, directly above)
@@ -263,6 +279,14 @@ void MarlinSettings::postprocess() {
     stepper.refresh_motor_power();
   #endif
 
+  #if ENABLED(INPUT_SHAPING)
+    stepper.refresh_shaping();
+  #endif
+
+  #if ENABLED(GRADIENT_MIX)
+    planner.refresh_gradient();
+  #endif
+
   // Refresh steps_to_mm with the reciprocal of axis_steps_per_mm
   // and init stepper.count[], planner.position[] with current_position
   planner.refresh_positioning();
@@ -725,6 +749,47 @@ void MarlinSettings::postprocess() {
       for (uint8_t q = 3; q--;) EEPROM_WRITE(dummy);
     #endif
 
+    //
+    // Input Shaping
+    //
+
+    #if ENABLED(INPUT_SHAPING)
+      EEPROM_WRITE(stepper.shaping_frequency);
+      EEPROM_WRITE(stepper.shaping_zeta);
+      EEPROM_WRITE(stepper.shaping_type);
+    #else
+      dummy = 0.0f;
+      for (uint8_t q = 4; q--;) EEPROM_WRITE(dummy);
+      const char dummyc = 0;
+      for (uint8_t q = 2; q--;) EEPROM_WRITE(dummyc);
+    #endif
+
+    //
+    // Gradient Mix
+    //
+
+    #if ENABLED(GRADIENT_MIX)
+      EEPROM_WRITE(planner.gradient.enabled);
+      EEPROM_WRITE(planner.gradient.start_vtool);
+      EEPROM_WRITE(planner.gradient.end_vtool);
+      EEPROM_WRITE(planner.gradient.vtool_index);
+      EEPROM_WRITE(planner.gradient.start_z);
+      EEPROM_WRITE(planner.gradient.end_z);
+    #else
+      const uint8_t dummy_vtool = 0;
+      for (uint8_t q = 4; q--;) EEPROM_WRITE(dummy_vtool);
+      dummy = 0.0f;
+      for (uint8_t q = 2; q--;) EEPROM_WRITE(dummy);
+    #endif
+
+    //
+    // Mixing Extruder Virtual Tools
+    //
+
+    #if ENABLED(MIXING_EXTRUDER) && MIXING_VIRTUAL_TOOLS > 1
+      EEPROM_WRITE(mixing_virtual_tool_mix);
+    #endif
+
     if (!eeprom_error) {
       const int eeprom_size = eeprom_index;
 
@@ -1207,6 +1272,45 @@ void MarlinSettings::postprocess() {
         for (uint8_t q = 3; q--;) EEPROM_READ(dummy);
       #endif
 
+      //
+      // Input Shaping
+      //
+
+      #if ENABLED(INPUT_SHAPING)
+        EEPROM_READ(stepper.shaping_frequency);
+        EEPROM_READ(stepper.shaping_zeta);
+        EEPROM_READ(stepper.shaping_type);
+      #else
+        for (uint8_t q = 4; q--;) EEPROM_READ(dummy);
+        char dummyc;
+        for (uint8_t q = 2; q--;) EEPROM_READ(dummyc);
+      #endif
+
+      //
+      // Gradient Mix
+      //
+
+      #if ENABLED(GRADIENT_MIX)
+        EEPROM_READ(planner.gradient.enabled);
+        EEPROM_READ(planner.gradient.start_vtool);
+        EEPROM_READ(planner.gradient.end_vtool);
+        EEPROM_READ(planner.gradient.vtool_index);
+        EEPROM_READ(planner.gradient.start_z);
+        EEPROM_READ(planner.gradient.end_z);
+      #else
+        uint8_t dummy_vtool;
+        for (uint8_t q = 4; q--;) EEPROM_READ(dummy_vtool);
+        for (uint8_t q = 2; q--;) EEPROM_READ(dummy);
+      #endif
+
+      //
+      // Mixing Extruder Virtual Tools
+      //
+
+      #if ENABLED(MIXING_EXTRUDER) && MIXING_VIRTUAL_TOOLS > 1
+        EEPROM_READ(mixing_virtual_tool_mix);
+      #endif
+
       if (working_crc == stored_crc) {
         postprocess();
         #if ENABLED(EEPROM_CHITCHAT)
@@ -1612,6 +1716,37 @@ void MarlinSettings::reset() {
     #endif
   #endif
 
+  #if ENABLED(INPUT_SHAPING)
+    stepper.shaping_frequency[X_AXIS] = SHAPING_FREQ_X;
+    stepper.shaping_frequency[Y_AXIS] = SHAPING_FREQ_Y;
+    stepper.shaping_zeta[X_AXIS] = SHAPING_ZETA_X;
+    stepper.shaping_zeta[Y_AXIS] = SHAPING_ZETA_Y;
+    stepper.shaping_type[X_AXIS] = SHAPING_TYPE_X;
+    stepper.shaping_type[Y_AXIS] = SHAPING_TYPE_Y;
+  #endif
+
+  #if ENABLED(MIXING_EXTRUDER) && MIXING_VIRTUAL_TOOLS > 1
+    // Virtual Tools 0, 1, 2, 3 = Filament 1, 2, 3, 4, etc.
+    for (uint8_t t = 0; t < MIXING_VIRTUAL_TOOLS && t < MIXING_STEPPERS; t++)
+      for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
+        mixing_virtual_tool_mix[t][i] = (t == i) ? 1.0 : 0.0;
+
+    // Remaining virtual tools are 100% filament 1
+    #if MIXING_STEPPERS < MIXING_VIRTUAL_TOOLS
+      for (uint8_t t = MIXING_STEPPERS; t < MIXING_VIRTUAL_TOOLS; t++)
+        for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
+          mixing_virtual_tool_mix[t][i] = (i == 0) ? 1.0 : 0.0;
+    #endif
+  #endif
+
+  #if ENABLED(GRADIENT_MIX)
+    planner.gradient.enabled = false;
+    planner.gradient.start_vtool = 0;
+    planner.gradient.end_vtool = 1;
+    planner.gradient.vtool_index = 0;
+    planner.gradient.start_z = planner.gradient.end_z = 0.0;
+  #endif
+
   postprocess();
 
   #if ENABLED(EEPROM_CHITCHAT)
@@ -2060,6 +2195,41 @@ void MarlinSettings::reset() {
       #endif
     #endif
 
+    /**
+     * Input Shaping
+     */
+    #if ENABLED(INPUT_SHAPING)
+      if (!forReplay) {
+        CONFIG_ECHO_START;
+        SERIAL_ECHOLNPGM("Input Shaping:");
+      }
+      CONFIG_ECHO_START;
+      SERIAL_ECHOPAIR("  M593 X F", stepper.shaping_frequency[X_AXIS]);
+      SERIAL_ECHOPAIR(" D", stepper.shaping_zeta[X_AXIS]);
+      SERIAL_ECHOLNPAIR(" T", (int)stepper.shaping_type[X_AXIS]);
+      CONFIG_ECHO_START;
+      SERIAL_ECHOPAIR("  M593 Y F", stepper.shaping_frequency[Y_AXIS]);
+      SERIAL_ECHOPAIR(" D", stepper.shaping_zeta[Y_AXIS]);
+      SERIAL_ECHOLNPAIR(" T", (int)stepper.shaping_type[Y_AXIS]);
+    #endif
+
+    /**
+     * Gradient Mix
+     */
+    #if ENABLED(GRADIENT_MIX)
+      if (!forReplay) {
+        CONFIG_ECHO_START;
+        SERIAL_ECHOLNPGM("Gradient Mix:");
+      }
+      CONFIG_ECHO_START;
+      SERIAL_ECHOPAIR("  M166 S", planner.gradient.enabled ? 1 : 0);
+      SERIAL_ECHOPAIR(" T", planner.gradient.vtool_index);
+      SERIAL_ECHOPAIR(" I", planner.gradient.start_vtool);
+      SERIAL_ECHOPAIR(" J", planner.gradient.end_vtool);
+      SERIAL_ECHOPAIR(" A", LINEAR_UNIT(planner.gradient.start_z));
+      SERIAL_ECHOLNPAIR(" Z", LINEAR_UNIT(planner.gradient.end_z));
+    #endif
+
     /**
      * TMC2130 stepper driver current
      */
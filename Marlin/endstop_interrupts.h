@@ -28,8 +28,15 @@
  * With this feature endstops.update() is called only when we know that at
  * least one endstop has changed state, saving valuable CPU cycles.
  *
- * This feature only works when all used endstop pins can generate either an
- * 'external interrupt' or a 'pin change interrupt'.
+ * The step position at the pin change is kept and reported as the trigger
+ * position, so homing and probing don't lose the steps taken while debouncing.
+ * The temperature ISR also checks the endstops every 64ms in case a change
+ * was missed.
+ *
+ * Endstop pins should generate either an 'external interrupt' or a 'pin change
+ * interrupt'. If any can't, the stepper ISR polls all the endstops as it does
+ * without this feature, and only the pins with interrupts get the exact
+ * trigger position.
  *
  * Test whether pins issue interrupts on your board by flashing 'pin_interrupt_test.ino'.
  * (Located in Marlin/buildroot/share/pin_interrupt_test/pin_interrupt_test.ino)
@@ -39,6 +46,7 @@
 #define _ENDSTOP_INTERRUPTS_H_
 
 #include "macros.h"
+#include "stepper.h"
 
 /**
  * Patch for pins_arduino.h (...\Arduino\hardware\arduino\avr\variants\mega\pins_arduino.h)
@@ -74,6 +82,7 @@
 
 volatile uint8_t e_hit = 0; // Different from 0 when the endstops should be tested in detail.
                             // Must be reset to 0 by the test function when finished.
+bool e_poll = false;        // Some endstop pins can't raise an interrupt, so the stepper ISR polls them.
 
 // Install Pin change interrupt for a pin. Can be called multiple times.
 void pciSetup(byte pin) {
@@ -84,6 +93,7 @@ void pciSetup(byte pin) {
 
 // This is what is really done inside the interrupts.
 FORCE_INLINE void endstop_ISR_worker( void ) {
+  Stepper::capture_endstop_edge();
   e_hit = 2; // Because the detection of a e-stop hit has a 1 step debouncer it has to be called at least twice.
 }
 
@@ -114,9 +124,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(X_MAX_PIN) != NOT_AN_INTERRUPT // if pin has an external interrupt
       attachInterrupt(digitalPinToInterrupt(X_MAX_PIN), endstop_ISR, CHANGE); // assign it
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(X_MAX_PIN) != NULL, "X_MAX_PIN is not interrupt-capable"); // if pin has no pin change interrupt - error
-      pciSetup(X_MAX_PIN);                                                            // assign it
+      if (digitalPinToPCICR(X_MAX_PIN)) pciSetup(X_MAX_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -124,9 +132,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(X_MIN_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(X_MIN_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(X_MIN_PIN) != NULL, "X_MIN_PIN is not interrupt-capable");
-      pciSetup(X_MIN_PIN);
+      if (digitalPinToPCICR(X_MIN_PIN)) pciSetup(X_MIN_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -134,9 +140,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(Y_MAX_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(Y_MAX_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Y_MAX_PIN) != NULL, "Y_MAX_PIN is not interrupt-capable");
-      pciSetup(Y_MAX_PIN);
+      if (digitalPinToPCICR(Y_MAX_PIN)) pciSetup(Y_MAX_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -144,9 +148,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(Y_MIN_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(Y_MIN_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Y_MIN_PIN) != NULL, "Y_MIN_PIN is not interrupt-capable");
-      pciSetup(Y_MIN_PIN);
+      if (digitalPinToPCICR(Y_MIN_PIN)) pciSetup(Y_MIN_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -154,9 +156,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(Z_MAX_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(Z_MAX_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Z_MAX_PIN) != NULL, "Z_MAX_PIN is not interrupt-capable");
-      pciSetup(Z_MAX_PIN);
+      if (digitalPinToPCICR(Z_MAX_PIN)) pciSetup(Z_MAX_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -164,9 +164,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(Z_MIN_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(Z_MIN_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Z_MIN_PIN) != NULL, "Z_MIN_PIN is not interrupt-capable");
-      pciSetup(Z_MIN_PIN);
+      if (digitalPinToPCICR(Z_MIN_PIN)) pciSetup(Z_MIN_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -174,9 +172,7 @@ void setup_endstop_interrupts( void ) {
     #if (digitalPinToInterrupt(X2_MAX_PIN) != NOT_AN_INTERRUPT)
       attachInterrupt(digitalPinToInterrupt(X2_MAX_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(X2_MAX_PIN) != NULL, "X2_MAX_PIN is not interrupt-capable");
-      pciSetup(X2_MAX_PIN);
+      if (digitalPinToPCICR(X2_MAX_PIN)) pciSetup(X2_MAX_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -184,9 +180,7 @@ void setup_endstop_interrupts( void ) {
     #if (digitalPinToInterrupt(X2_MIN_PIN) != NOT_AN_INTERRUPT)
       attachInterrupt(digitalPinToInterrupt(X2_MIN_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(X2_MIN_PIN) != NULL, "X2_MIN_PIN is not interrupt-capable");
-      pciSetup(X2_MIN_PIN);
+      if (digitalPinToPCICR(X2_MIN_PIN)) pciSetup(X2_MIN_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -194,9 +188,7 @@ void setup_endstop_interrupts( void ) {
     #if (digitalPinToInterrupt(Y2_MAX_PIN) != NOT_AN_INTERRUPT)
       attachInterrupt(digitalPinToInterrupt(Y2_MAX_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Y2_MAX_PIN) != NULL, "Y2_MAX_PIN is not interrupt-capable");
-      pciSetup(Y2_MAX_PIN);
+      if (digitalPinToPCICR(Y2_MAX_PIN)) pciSetup(Y2_MAX_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -204,9 +196,7 @@ void setup_endstop_interrupts( void ) {
     #if (digitalPinToInterrupt(Y2_MIN_PIN) != NOT_AN_INTERRUPT)
       attachInterrupt(digitalPinToInterrupt(Y2_MIN_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Y2_MIN_PIN) != NULL, "Y2_MIN_PIN is not interrupt-capable");
-      pciSetup(Y2_MIN_PIN);
+      if (digitalPinToPCICR(Y2_MIN_PIN)) pciSetup(Y2_MIN_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -214,9 +204,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(Z2_MAX_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(Z2_MAX_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Z2_MAX_PIN) != NULL, "Z2_MAX_PIN is not interrupt-capable");
-      pciSetup(Z2_MAX_PIN);
+      if (digitalPinToPCICR(Z2_MAX_PIN)) pciSetup(Z2_MAX_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -224,9 +212,7 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(Z2_MIN_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(Z2_MIN_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Z2_MIN_PIN) != NULL, "Z2_MIN_PIN is not interrupt-capable");
-      pciSetup(Z2_MIN_PIN);
+      if (digitalPinToPCICR(Z2_MIN_PIN)) pciSetup(Z2_MIN_PIN); else e_poll = true;
     #endif
   #endif
 
@@ -234,13 +220,11 @@ void setup_endstop_interrupts( void ) {
     #if digitalPinToInterrupt(Z_MIN_PROBE_PIN) != NOT_AN_INTERRUPT
       attachInterrupt(digitalPinToInterrupt(Z_MIN_PROBE_PIN), endstop_ISR, CHANGE);
     #else
-      // Not all used endstop/probe -pins can raise interrupts. Please deactivate ENDSTOP_INTERRUPTS or change the pin configuration!
-      static_assert(digitalPinToPCICR(Z_MIN_PROBE_PIN) != NULL, "Z_MIN_PROBE_PIN is not interrupt-capable");
-      pciSetup(Z_MIN_PROBE_PIN);
+      if (digitalPinToPCICR(Z_MIN_PROBE_PIN)) pciSetup(Z_MIN_PROBE_PIN); else e_poll = true;
     #endif
   #endif
 
-  // If we arrive here without raising an assertion, each pin has either an EXT-interrupt or a PCI.
+  // Pins with neither an EXT-interrupt nor a PCI have set e_poll.
 }
 
 #endif // _ENDSTOP_INTERRUPTS_H_
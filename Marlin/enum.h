@@ -178,7 +178,19 @@ enum LCDViewAction {
   enum DualXMode {
     DXC_FULL_CONTROL_MODE,  // DUAL_X_CARRIAGE only
     DXC_AUTO_PARK_MODE,     // DUAL_X_CARRIAGE only
-    DXC_DUPLICATION_MODE
+    DXC_DUPLICATION_MODE,
+    DXC_MIRRORED_MODE       // DUAL_X_CARRIAGE only
+  };
+#endif
+
+/**
+ * Input shapers, by number of impulses and tolerance to frequency error
+ */
+#if ENABLED(INPUT_SHAPING)
+  enum ShaperType : char {
+    SHAPER_ZV,   // Two impulses, half a period apart
+    SHAPER_ZVD,  // Three impulses over a full period
+    SHAPER_MZV   // Three impulses over 3/4 of a period
   };
 #endif
 
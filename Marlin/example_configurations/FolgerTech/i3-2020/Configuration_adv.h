@@ -329,6 +329,8 @@
   //    Mode 2 (DXC_DUPLICATION_MODE) : Duplication mode. The firmware will transparently make the second x-carriage and extruder copy all
   //                                    actions of the first x-carriage. This allows the printer to print 2 arbitrary items at
   //                                    once. (2nd extruder x offset and temp offset are set using: M605 S2 [Xnnn] [Rmmm])
+  //    Mode 3 (DXC_MIRRORED_MODE)    : Mirrored mode. Like duplication mode, but the second x-carriage moves opposite to the first,
+  //                                    reflected about the bed center, to print 2 symmetric items at once. (M605 S3 [Rmmm])
 
   // This is the default power-up mode which can be later using M605.
   #define DEFAULT_DUAL_X_CARRIAGE_MODE DXC_FULL_CONTROL_MODE
@@ -400,6 +402,54 @@
 // If defined the movements slow down when the look ahead buffer is only half full
 #define SLOWDOWN
 
+/**
+ * Adaptive Slowdown
+ *
+ * Measure how quickly new moves arrive from the host or SD card and, when
+ * less than ADAPTIVE_SLOWDOWN_QUEUE_MS of motion is queued, stretch short
+ * segments towards that arrival rate. The printer slows just enough to keep
+ * the planner fed instead of stopping and starting when input can't keep up.
+ */
+//#define ADAPTIVE_SLOWDOWN
+#if ENABLED(ADAPTIVE_SLOWDOWN)
+  #define ADAPTIVE_SLOWDOWN_QUEUE_MS   100  // (ms) Start slowing when less motion than this is queued
+  #define ADAPTIVE_SLOWDOWN_MAX_GAP_MS  50  // (ms) A longer pause between moves restarts the rate estimate
+#endif
+
+/**
+ * Planner Time Watermark
+ *
+ * Measure the look-ahead buffer by queued motion time instead of block count.
+ * With short segments a full buffer may hold only a few milliseconds of motion.
+ * While less than PLANNER_TARGET_QUEUE_MS is queued, SLOWDOWN applies and queued
+ * commands go to the planner ahead of the idle tasks, which wait up to a quarter
+ * of the target time when the queue is nearly empty. With ADVANCED_OK the 'ok'
+ * reply also includes the queued time as T<ms>.
+ */
+//#define PLANNER_TIME_WATERMARK
+#if ENABLED(PLANNER_TIME_WATERMARK)
+  #define PLANNER_TARGET_QUEUE_MS 250  // (ms) Motion time to keep in the planner
+#endif
+
+/**
+ * Move Coalescing
+ *
+ * Merge runs of short, nearly collinear G0/G1 moves into a single planner
+ * block. This gives more look-ahead and less planner work per mm on finely
+ * tessellated models. Moves are merged only while the direction, feedrate,
+ * and extrusion per mm stay the same and the merged line stays within
+ * MOVE_COALESCE_DEVIATION of every point it replaces, up to
+ * MOVE_COALESCE_MAX_LENGTH.
+ * Not for kinematic machines. Mesh leveled moves are not merged.
+ */
+//#define MOVE_COALESCING
+#if ENABLED(MOVE_COALESCING)
+  #define MOVE_COALESCE_DEVIATION 0.005  // (mm) Maximum distance of a replaced point from the merged line
+  #define MOVE_COALESCE_MAX_ANGLE 2      // (°) Maximum direction change between merged moves
+  #define MOVE_COALESCE_E_RATIO   0.02   // Maximum relative change in extrusion per mm
+  #define MOVE_COALESCE_MAX_LENGTH 10    // (mm) Longest merged move, so the planner never waits on a held move
+#endif
+
 // Frequency limit
 // See nophead's blog for more info
 // Not working O
@@ -511,6 +561,19 @@
   #define SD_FINISHED_STEPPERRELEASE true          // Disable steppers when SD Print is finished
   #define SD_FINISHED_RELEASECOMMAND "M84 X Y Z E" // You might want to keep the z enabled so your bed stays in place.
 
+  // Read sequential blocks (e.g., while SD printing) with one multiple block
+  // read command (CMD18) instead of a command per block. Disable for problem cards.
+  //#define SD_MULTIBLOCK_READ
+
+  // Gather M28 uploads and M928 logs into whole 512-byte blocks, written with one
+  // multiple block write (CMD25) so the card doesn't stall each block. Uses 512 bytes of SRAM.
+  //#define SD_BUFFERED_WRITE
+
+  // Keep a hidden compact copy (NAME.MCC) of each printed G-code file, without comments,
+  // line numbers, spaces and surplus zeros. The copy is built in the background while the
+  // file is first printed. Later prints of the unchanged file read the smaller copy.
+  //#define SD_GCODE_CACHE
+
   // Reverse SD sort to show "more recent" files first, according to the card's FAT.
   // Since the FAT gets out of order with usage, SDCARD_SORT_ALPHA is recommended.
   #define SDCARD_RATHERRECENTFIRST
@@ -554,6 +617,8 @@
     #define SDSORT_DYNAMIC_RAM false  // Use dynamic allocation (within SD menus). Least expensive option. Set SDSORT_LIMIT before use!
     #define SDSORT_CACHE_VFATS 2      // Maximum number of 13-byte VFAT entries to use for sorting.
                                       // Note: Only affects SCROLL_LONG_FILENAMES with SDSORT_CACHE_NAMES but not SDSORT_DYNAMIC_RAM.
+    #define SDSORT_INDEX_FILE  false  // Keep a hidden sorted index (SDSORT.IDX) in each folder. Faster SD menus with many files.
+                                      // Note: Written when a folder changes. Requires SDSORT_USES_RAM false.
   #endif
 
   // Show a progress bar on HD44780 LCDs for SD printing
@@ -628,6 +693,19 @@
   // The normal delay is 10µs. Use the lowest value that still gives a reliable display.
   //#define DOGM_SPI_DELAY_US 5
 
+  // Full Graphic (ST7920) displays: Keep a checksum of each pixel row and only
+  // send rows that changed since the last frame. Costs 128 bytes of SRAM.
+  //#define ST7920_SEND_CHANGED_ROWS
+
+  // Budget display drawing by the motion time queued in the planner. Draw as many
+  // pages per call as half the spare queued time allows, and none when the planner
+  // is close to running dry. Replaces the max_display_update_time throttle.
+  //#define LCD_PLANNER_BUDGET
+  #if ENABLED(LCD_PLANNER_BUDGET)
+    #define LCD_BUDGET_RESERVE_MS    20  // (ms) Don't draw with less motion than this queued
+    #define LCD_BUDGET_MAX_US     20000  // (µs) Most time to spend drawing in one call
+  #endif
+
   // Swap the CW/CCW indicators in the graphics overlay
   //#define OVERLAY_GFX_REVERSE
 
@@ -660,6 +738,7 @@
   //#define BABYSTEP_XY              // Also enable X/Y Babystepping. Not supported on DELTA!
   #define BABYSTEP_INVERT_Z false    // Change if Z babysteps should go the other way
   #define BABYSTEP_MULTIPLICATOR   2 // Babysteps are very small. Increase for faster motion.
+  #define BABYSTEP_MAX_RATE 2000     // (steps/s) Fastest babystepping rate, per axis.
   //#define BABYSTEP_ZPROBE_OFFSET   // Enable to combine M851 and Babystepping
   #define DOUBLECLICK_FOR_Z_BABYSTEPPING // Double-click on the Status Screen for Z Babystepping.
   #define DOUBLECLICK_MAX_INTERVAL 1250 // Maximum interval between clicks, in milliseconds.
@@ -667,6 +746,36 @@
   //#define BABYSTEP_ZPROBE_GFX_OVERLAY // Enable graphical overlay on Z-offset editor
 #endif
 
+// @section motion
+
+/**
+ * Input Shaping
+ *
+ * Cancel the ringing (ghosting) of the X and Y axes so higher accelerations
+ * can be used. Each step is split into two or three impulses spaced so that
+ * the vibration started by one is cancelled by the next. Cartesian machines only.
+ * Homing and probing moves are not shaped, so the endstops stop the carriage
+ * at the counted position.
+ *
+ * Print a ringing test and divide the speed by the distance between ripples
+ * to find the frequency of each axis. Tune with M593 and save with M500.
+ *
+ *   SHAPER_ZV  : Two impulses over half a period. Least smoothing.
+ *   SHAPER_ZVD : Three impulses over a full period. Tolerates frequency error.
+ *   SHAPER_MZV : Three impulses over 3/4 of a period. A good compromise.
+ */
+//#define INPUT_SHAPING
+#if ENABLED(INPUT_SHAPING)
+  #define SHAPING_FREQ_X 40           // (Hz) Ringing frequency of X. 0 to disable. M593 X F<freq>
+  #define SHAPING_FREQ_Y 40           // (Hz) Ringing frequency of Y. 0 to disable. M593 Y F<freq>
+  #define SHAPING_ZETA_X 0.1          // Damping ratio of X (0.0 - 0.5). M593 X D<zeta>
+  #define SHAPING_ZETA_Y 0.1          // Damping ratio of Y (0.0 - 0.5). M593 Y D<zeta>
+  #define SHAPING_TYPE_X SHAPER_ZV    // SHAPER_ZV, SHAPER_ZVD, or SHAPER_MZV. M593 X T<0|1|2>
+  #define SHAPING_TYPE_Y SHAPER_ZV
+  #define SHAPING_MIN_FREQ 10         // (Hz) Lowest frequency accepted by M593
+  #define SHAPING_BUFFER_SIZE 64      // Queued step events (4 bytes each). Power of 2 up to 256.
+#endif
+
 // @section extruder
 
 /**
@@ -675,6 +784,9 @@
  * Assumption: advance = k * (delta velocity)
  * K=0 means advance disabled.
  * See Marlin documentation for calibration instructions.
+ *
+ * Advance steps are taken by the stepper ISR along with the regular E steps.
+ * Print moves accelerate no faster than the advance can follow within E jerk.
  */
 //#define LIN_ADVANCE
 
@@ -1091,6 +1203,22 @@
     #define STOP_ON_ERROR
   #endif
 
+  /**
+   * Lower the run current of lightly loaded TMC2130 drivers and raise it again
+   * when the load rises or a hard acceleration is queued. Motors and drivers run
+   * cooler, leaving room for a higher set current. Load is taken from stallGuard,
+   * so it only works in spreadCycle (STEALTHCHOP disabled or HYBRID_THRESHOLD).
+   * Requires MONITOR_DRIVER_STATUS. Tune the thresholds against M122 "sg_average".
+   */
+  //#define ADAPTIVE_CURRENT
+  #if ENABLED(ADAPTIVE_CURRENT)
+    #define ADAPTIVE_CURRENT_MIN      60  // (%) Lowest run current, relative to the M906 current
+    #define ADAPTIVE_CURRENT_SG_LOW  100  // Average SG_RESULT below this restores the full current
+    #define ADAPTIVE_CURRENT_SG_HIGH 300  // Average SG_RESULT above this lowers the current a step
+    #define ADAPTIVE_CURRENT_ACCEL ((DEFAULT_ACCELERATION) * 3 / 2) // (mm/s^2) Queued moves at this acceleration restore the full current.
+                                                            // Must be above DEFAULT_ACCELERATION, or every print move does.
+  #endif
+
   /**
    * The driver will switch to spreadCycle when stepper speed is over HYBRID_THRESHOLD.
    * This mode allows for faster movements at the expense of higher noise levels.
@@ -1360,6 +1488,17 @@
  */
 #define PINS_DEBUGGING
 
+/**
+ * ISR Profiling
+ *
+ * Collect min/max/average run times for the stepper and temperature ISRs,
+ * a count of late stepper timer compares, the main loop period, and the
+ * number of times the planner ran dry while commands were waiting.
+ * Use M123 to report the statistics and M123 R to report and reset them.
+ * Useful for tuning segments per second, microstepping, and BLOCK_BUFFER_SIZE.
+ */
+//#define ISR_PROFILING
+
 /**
  * Auto-report temperatures with M155 S<seconds>
  */
@@ -1531,6 +1670,25 @@
   // Use a rolling average to identify persistant errors that indicate skips, as opposed to vibration and noise.
   #define I2CPE_ERR_ROLLING_AVERAGE
 
+  /**
+   * Read the encoders in the background, one bus event per idle() call, instead of
+   * waiting for each module in turn. Error correction then uses the latest reading.
+   * The encoders must be the only devices on the I2C bus.
+   */
+  //#define I2CPE_ASYNC_READ
+
+  /**
+   * Measure the ringing frequency and damping of an axis with M870. A short move is made
+   * and the encoder is sampled at a fixed rate while the axis settles. Use the results to
+   * set up INPUT_SHAPING (M870 U) or to find the highest acceleration with little ringing.
+   */
+  //#define I2CPE_RINGING_MEASUREMENT
+  #if ENABLED(I2CPE_RINGING_MEASUREMENT)
+    #define I2CPE_RINGING_SAMPLES   250                     // Samples per measurement (2 bytes of SRAM each).
+    #define I2CPE_RINGING_INTERVAL  1000                    // (µs) Time between samples. Longer than one I2C read.
+    #define I2CPE_RINGING_DISTANCE  5                       // (mm) Length of the move that excites the axis.
+  #endif
+
 #endif // I2C_POSITION_ENCODERS
 
 /**
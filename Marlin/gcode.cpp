@@ -81,6 +81,65 @@ void GCodeParser::reset() {
   #endif
 }
 
+/**
+ * Parse a G-code number: [-+][digits][.digits]
+ *
+ * The first 9 significant digits are gathered into an integer and scaled
+ * once by a power of ten. Numbers with up to 7 significant digits (all
+ * practical G-code values) come out the same as from strtod. Longer ones
+ * may differ in the last bit.
+ */
+static const float powers_of_ten[] PROGMEM = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+
+float GCodeParser::parse_float(const char *p) {
+  while (*p == ' ') p++;
+  const bool neg = (*p == '-');
+  if (neg || *p == '+') p++;
+
+  uint32_t mant = 0;
+  uint8_t digits = 0;
+  int8_t exp10 = 0;
+  for (; NUMERIC(*p); p++) {
+    if (digits < 9) {
+      mant = mant * 10 + (*p - '0');
+      if (mant) digits++;
+    }
+    else
+      exp10++;                            // Dropped integer digit
+  }
+  if (*p == '.')
+    for (p++; NUMERIC(*p); p++) {
+      if (digits < 9) {
+        mant = mant * 10 + (*p - '0');
+        if (mant) digits++;
+        if (exp10 > -99) exp10--;         // Kept fractional digit
+      }
+    }
+
+  float f = mant;
+  while (exp10 < 0) {
+    const int8_t k = exp10 < -9 ? 9 : -exp10;
+    f /= pgm_read_float(&powers_of_ten[k]);
+    exp10 += k;
+  }
+  while (exp10 > 0) {
+    const int8_t k = exp10 > 9 ? 9 : exp10;
+    f *= pgm_read_float(&powers_of_ten[k]);
+    exp10 -= k;
+  }
+  return neg ? -f : f;
+}
+
+// Like strtoul, a '-' sign negates the unsigned result
+uint32_t GCodeParser::parse_ulong(const char *p) {
+  while (*p == ' ') p++;
+  const bool neg = (*p == '-');
+  if (neg || *p == '+') p++;
+  uint32_t val = 0;
+  while (NUMERIC(*p)) val = val * 10 + (*p++ - '0');
+  return neg ? -val : val;
+}
+
 // Populate all fields by parsing a single line of GCode
 // 58 bytes of SRAM are used to speed up seen/value
 void GCodeParser::parse(char *p) {
@@ -178,29 +178,16 @@ public:
   // Seen a parameter with a value
   inline static bool seenval(const char c) { return seen(c) && has_value(); }
 
-  // Float removes 'E' to prevent scientific notation interpretation
-  inline static float value_float() {
-    if (value_ptr) {
-      char *e = value_ptr;
-      for (;;) {
-        const char c = *e;
-        if (c == '\0' || c == ' ') break;
-        if (c == 'E' || c == 'e') {
-          *e = '\0';
-          const float ret = strtod(value_ptr, NULL);
-          *e = c;
-          return ret;
-        }
-        ++e;
-      }
-      return strtod(value_ptr, NULL);
-    }
-    return 0.0;
-  }
+  // Decimal parsers for G-code numbers, much faster than strtod / strtoul
+  static float parse_float(const char *p);
+  static uint32_t parse_ulong(const char *p);
+
+  // Float has no scientific notation, so 'E' always starts a new parameter
+  inline static float value_float() { return value_ptr ? parse_float(value_ptr) : 0.0; }
 
   // Code value as a long or ulong
-  inline static int32_t value_long() { return value_ptr ? strtol(value_ptr, NULL, 10) : 0L; }
-  inline static uint32_t value_ulong() { return value_ptr ? strtoul(value_ptr, NULL, 10) : 0UL; }
+  inline static int32_t value_long() { return value_ptr ? (int32_t)parse_ulong(value_ptr) : 0L; }
+  inline static uint32_t value_ulong() { return value_ptr ? parse_ulong(value_ptr) : 0UL; }
 
   // Code value for use as time
   FORCE_INLINE static millis_t value_millis() { return value_ulong(); }
@@ -0,0 +1,121 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (C) 2017 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * isr_profiler.cpp - Timing statistics for the stepper and temperature ISRs
+ */
+
+#include "MarlinConfig.h"
+
+#if ENABLED(ISR_PROFILING)
+
+#include "isr_profiler.h"
+
+ISRProfiler isr_profiler;
+
+isr_timing_t ISRProfiler::stepper_isr, ISRProfiler::temp_isr;
+
+millis_t ISRProfiler::loop_min, ISRProfiler::loop_max, ISRProfiler::loop_total;
+uint32_t ISRProfiler::loop_count;
+
+volatile uint16_t ISRProfiler::late_compares, ISRProfiler::starvations;
+volatile bool ISRProfiler::synchronizing = false,
+              ISRProfiler::dwelling = false;
+bool ISRProfiler::was_busy = false;
+
+static millis_t last_loop_us = 0;
+
+static void reset_timing(isr_timing_t &t) {
+  t.min = 0xFFFF;
+  t.max = t.total = t.count = 0;
+}
+
+void ISRProfiler::reset() {
+  CRITICAL_SECTION_START;
+  reset_timing(stepper_isr);
+  reset_timing(temp_isr);
+  late_compares = starvations = 0;
+  CRITICAL_SECTION_END;
+
+  loop_min = 0xFFFFFFFF;
+  loop_max = loop_total = loop_count = 0;
+  last_loop_us = 0;
+}
+
+void ISRProfiler::loop_tick() {
+  const millis_t now = micros();
+  if (last_loop_us) {
+    const millis_t period = now - last_loop_us;
+    NOMORE(loop_min, period);
+    NOLESS(loop_max, period);
+    if (loop_total & 0x80000000UL) { loop_total >>= 1; loop_count >>= 1; }
+    loop_total += period;
+    loop_count++;
+  }
+  last_loop_us = now;
+}
+
+void ISRProfiler::report_timing(const char * const name, const isr_timing_t &t, const uint8_t prescaler) {
+  // Copy the stats so the ISR can't change them while printing
+  CRITICAL_SECTION_START;
+  const isr_timing_t snap = t;
+  CRITICAL_SECTION_END;
+
+  const float us_per_tick = float(prescaler) / (CYCLES_PER_MICROSECOND);
+
+  SERIAL_ECHO_START();
+  serialprintPGM(name);
+  if (snap.count) {
+    SERIAL_ECHOPAIR(" min:", snap.min * us_per_tick);
+    SERIAL_ECHOPAIR(" max:", snap.max * us_per_tick);
+    SERIAL_ECHOPAIR(" avg:", snap.total * us_per_tick / snap.count);
+    SERIAL_ECHOLNPAIR("us runs:", snap.count);
+  }
+  else
+    SERIAL_ECHOLNPGM(" no data");
+}
+
+void ISRProfiler::report() {
+  report_timing(PSTR("Stepper ISR"), stepper_isr, ISRP_TIMER1_PRESCALER);
+  report_timing(PSTR("Temp ISR"), temp_isr, ISRP_TIMER0_PRESCALER);
+
+  SERIAL_ECHO_START();
+  SERIAL_ECHOPGM("Main loop");
+  if (loop_count) {
+    SERIAL_ECHOPAIR(" min:", loop_min);
+    SERIAL_ECHOPAIR(" max:", loop_max);
+    SERIAL_ECHOPAIR(" avg:", loop_total / loop_count);
+    SERIAL_ECHOLNPAIR("us loops:", loop_count);
+  }
+  else
+    SERIAL_ECHOLNPGM(" no data");
+
+  CRITICAL_SECTION_START;
+  const uint16_t late = late_compares, starved = starvations;
+  CRITICAL_SECTION_END;
+
+  SERIAL_ECHO_START();
+  SERIAL_ECHOPAIR("Late compares:", late);
+  SERIAL_ECHOLNPAIR(" Planner starvation:", starved);
+}
+
+#endif // ISR_PROFILING
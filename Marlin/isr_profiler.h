@@ -0,0 +1,133 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (C) 2017 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * isr_profiler.h - Timing statistics for the stepper and temperature ISRs
+ *
+ * Stepper ISR durations are taken from Timer1, which restarts from 0 at
+ * every compare match, so its count at the end of the ISR is the time since
+ * the interrupt was due (entry latency included). The temperature ISR is
+ * timed with Timer0, which wraps every 1.024ms at 16MHz.
+ */
+
+#ifndef ISR_PROFILER_H
+#define ISR_PROFILER_H
+
+#include "Marlin.h"
+
+#if ENABLED(ISR_PROFILING)
+
+#define ISRP_TIMER1_PRESCALER  8 // Stepper timer
+#define ISRP_TIMER0_PRESCALER 64 // Arduino millis() timer, also drives the temperature ISR
+
+typedef struct {
+  uint16_t min, max;  // Shortest and longest run, in timer ticks
+  uint32_t total,     // Sum of all runs, in timer ticks
+           count;     // Number of runs
+} isr_timing_t;
+
+class ISRProfiler {
+
+  public:
+
+    static isr_timing_t stepper_isr, temp_isr;
+
+    static millis_t loop_min, loop_max, loop_total; // Main loop period, in µs
+    static uint32_t loop_count;
+
+    static volatile uint16_t late_compares, // Next step was already due when the stepper ISR finished
+                             starvations;   // Planner ran dry while commands were waiting
+                                            // Both counters stop at 65535 rather than wrap
+
+    static volatile bool synchronizing,     // Set while the queue is drained on purpose
+                         dwelling;          // Set during G4 and other timed waits
+
+    ISRProfiler() { reset(); }
+
+    /**
+     * Clear all statistics (M123 R)
+     */
+    static void reset();
+
+    /**
+     * Print all statistics (M123)
+     */
+    static void report();
+
+    /**
+     * Add one ISR run to a set of statistics. Call from the ISR itself.
+     */
+    FORCE_INLINE static void record(isr_timing_t &t, const uint16_t ticks) {
+      NOMORE(t.min, ticks);
+      NOLESS(t.max, ticks);
+      // Halve the sums before they can overflow. The average is unchanged.
+      if (t.total & 0x80000000UL) { t.total >>= 1; t.count >>= 1; }
+      t.total += ticks;
+      t.count++;
+    }
+
+    /**
+     * Called by the stepper ISR whenever it has to push OCR1A out because
+     * the compare it wanted to set is already in the past.
+     */
+    FORCE_INLINE static void late_compare() { if (late_compares < 0xFFFF) late_compares++; }
+
+    /**
+     * Called by the stepper ISR on every check for a new block.
+     * A block running out with commands still queued is counted as
+     * starvation, unless the firmware is draining the queue on purpose:
+     * synchronize(), a dwell, a heatup wait (M109/M190) or a pause (M0/M1).
+     */
+    FORCE_INLINE static void block_check(const bool got_block) {
+      if (got_block)
+        was_busy = true;
+      else if (was_busy) {
+        was_busy = false;
+        if (commands_in_queue && !waiting() && starvations < 0xFFFF) starvations++;
+      }
+    }
+
+    /**
+     * Called once per pass of the main loop
+     */
+    static void loop_tick();
+
+  private:
+
+    static bool was_busy;
+
+    FORCE_INLINE static bool waiting() {
+      return synchronizing || dwelling || wait_for_heatup
+        #if HAS_RESUME_CONTINUE
+          || wait_for_user
+        #endif
+      ;
+    }
+
+    static void report_timing(const char * const name, const isr_timing_t &t, const uint8_t prescaler);
+};
+
+extern ISRProfiler isr_profiler;
+
+#endif // ISR_PROFILING
+
+#endif // ISR_PROFILER_H
@@ -177,10 +177,32 @@ float Planner::previous_speed[NUM_AXIS],
         Planner::lin_dist_e;
 #endif
 
-#if ENABLED(ULTRA_LCD)
+#if HAS_BLOCK_BUFFER_RUNTIME
   volatile uint32_t Planner::block_buffer_runtime_us = 0;
 #endif
 
+#if ENABLED(MOVE_COALESCING)
+  bool Planner::coalesce_pending = false;
+  float Planner::coalesce_start[XYZE],
+        Planner::coalesce_end[XYZE],
+        Planner::coalesce_fr_mm_s,
+        Planner::coalesce_deviation;
+  uint8_t Planner::coalesce_extruder;
+#endif
+
+#if ENABLED(ADAPTIVE_SLOWDOWN)
+  uint32_t Planner::last_arrival_us = 0,
+           Planner::arrival_interval_us = 0;
+#endif
+
+#if ENABLED(GRADIENT_MIX)
+  gradient_t Planner::gradient;           // Initialized by settings.load()
+  bool Planner::gradient_valid = false;
+  float Planner::gradient_last_z,
+        Planner::gradient_start_mix[MIXING_STEPPERS],
+        Planner::gradient_delta_mix[MIXING_STEPPERS];
+#endif
+
 /**
  * Class and Instance Methods
  */
@@ -236,12 +258,19 @@ void Planner::calculate_trapezoid_for_block(block_t* const block, const float &e
   // block->accelerate_until = accelerate_steps;
   // block->decelerate_after = accelerate_steps+plateau_steps;
 
+  #if ENABLED(LIN_ADVANCE)
+    const uint16_t final_adv_steps = block->use_advance_lead ? (final_rate * block->abs_adv_steps_multiplier8) >> 17 : 0;
+  #endif
+
   CRITICAL_SECTION_START;  // Fill variables used by the stepper in a critical section
   if (!TEST(block->flag, BLOCK_BIT_BUSY)) { // Don't update variables if block is busy.
     block->accelerate_until = accelerate_steps;
     block->decelerate_after = accelerate_steps + plateau_steps;
     block->initial_rate = initial_rate;
     block->final_rate = final_rate;
+    #if ENABLED(LIN_ADVANCE)
+      block->final_adv_steps = final_adv_steps;
+    #endif
   }
   CRITICAL_SECTION_END;
 }
@@ -793,6 +822,11 @@ void Planner::_buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const
   // Calculate the buffer head after we push this byte
   const uint8_t next_buffer_head = next_block_index(block_buffer_head);
 
+  #if ENABLED(ADAPTIVE_SLOWDOWN)
+    // A wait for room measures how fast blocks drain, not how fast moves arrive
+    const bool waited = (block_buffer_tail == next_buffer_head);
+  #endif
+
   // If the buffer is full: good! That means we are well ahead of the robot.
   // Rest here until there is room in the buffer.
   while (block_buffer_tail == next_buffer_head) idle();
@@ -1041,25 +1075,63 @@ void Planner::_buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const
   const uint8_t moves_queued = movesplanned();
 
   // Slow down when the buffer starts to empty, rather than wait at the corner for a buffer refill
-  #if ENABLED(SLOWDOWN) || ENABLED(ULTRA_LCD) || defined(XY_FREQUENCY_LIMIT)
+  #if ENABLED(SLOWDOWN) || HAS_BLOCK_BUFFER_RUNTIME || defined(XY_FREQUENCY_LIMIT)
     // Segment time im micro seconds
     uint32_t segment_time_us = LROUND(1000000.0 / inverse_secs);
   #endif
 
   #if ENABLED(SLOWDOWN)
-    if (WITHIN(moves_queued, 2, (BLOCK_BUFFER_SIZE) / 2 - 1)) {
+    #if ENABLED(PLANNER_TIME_WATERMARK)
+      if (moves_queued > 1 && block_buffer_runtime() < (PLANNER_TARGET_QUEUE_MS)) {
+    #else
+      if (WITHIN(moves_queued, 2, (BLOCK_BUFFER_SIZE) / 2 - 1)) {
+    #endif
       if (segment_time_us < min_segment_time_us) {
         // buffer is draining, add extra time.  The amount of time added increases if the buffer is still emptied more.
         const uint32_t nst = segment_time_us + LROUND(2 * (min_segment_time_us - segment_time_us) / moves_queued);
         inverse_secs = 1000000.0 / nst;
-        #if defined(XY_FREQUENCY_LIMIT) || ENABLED(ULTRA_LCD)
+        #if defined(XY_FREQUENCY_LIMIT) || HAS_BLOCK_BUFFER_RUNTIME
           segment_time_us = nst;
         #endif
       }
     }
   #endif
 
-  #if ENABLED(ULTRA_LCD)
+  #if ENABLED(ADAPTIVE_SLOWDOWN)
+    {
+      // Track the average time between incoming moves. A long gap (heating,
+      // dwell, a paused host) starts a new stream, so forget the old average.
+      // A move that waited for room is only the start of the next gap.
+      const uint32_t now = micros(), gap = now - last_arrival_us;
+      last_arrival_us = now;
+      if (!waited) {
+        if (gap > (ADAPTIVE_SLOWDOWN_MAX_GAP_MS) * 1000UL)
+          arrival_interval_us = 0;
+        else if (arrival_interval_us)
+          arrival_interval_us += ((int32_t)gap - (int32_t)arrival_interval_us) / 8;
+        else
+          arrival_interval_us = gap;
+      }
+
+      // Moves that execute faster than they arrive drain the buffer. Stretch the segment
+      // towards the arrival interval as the queued time falls below the target, so the
+      // printer slows smoothly instead of stopping when the buffer runs dry.
+      if (segment_time_us < arrival_interval_us) {
+        CRITICAL_SECTION_START
+          const uint32_t queued_us = block_buffer_runtime_us;
+        CRITICAL_SECTION_END
+        if (queued_us < (ADAPTIVE_SLOWDOWN_QUEUE_MS) * 1000UL) {
+          const float lag = 1.0 - queued_us * (1.0 / ((ADAPTIVE_SLOWDOWN_QUEUE_MS) * 1000.0));
+          segment_time_us += LROUND((arrival_interval_us - segment_time_us) * lag);
+          inverse_secs = 1000000.0 / segment_time_us;
+        }
+      }
+    }
+  #endif
+
+  #if HAS_BLOCK_BUFFER_RUNTIME
+    // Remembered so get_current_block() can take it back off the total
+    block->segment_time_us = segment_time_us;
     CRITICAL_SECTION_START
       block_buffer_runtime_us += segment_time_us;
     CRITICAL_SECTION_END
@@ -1157,6 +1229,37 @@ void Planner::_buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const
     block->nominal_rate *= speed_factor;
   }
 
+  #if ENABLED(LIN_ADVANCE)
+    /**
+     *
+     * Use LIN_ADVANCE for blocks if all these are true:
+     *
+     * esteps && (block->steps[X_AXIS] || block->steps[Y_AXIS]) : This is a print move
+     *
+     * extruder_advance_k                 : There is an advance factor set.
+     *
+     * esteps != block->step_event_count  : A problem occurs if the move before a retract is too small.
+     *                                      In that case, the retract and move will be executed together.
+     *                                      This leads to too many advance steps due to a huge e_acceleration.
+     *                                      The math is good, but we must avoid retract moves with advance!
+     * lin_dist_e > 0                       : Extruder is running forward (e.g., for "Wipe while retracting" (Slic3r) or "Combing" (Cura) moves)
+     */
+    block->use_advance_lead =  esteps && (block->steps[X_AXIS] || block->steps[Y_AXIS])
+                            && extruder_advance_k
+                            && (uint32_t)esteps != block->step_event_count
+                            && lin_dist_e > 0;
+    if (block->use_advance_lead) {
+      block->abs_adv_steps_multiplier8 = LROUND(
+        extruder_advance_k
+        * (UNEAR_ZERO(advance_ed_ratio) ? lin_dist_e / lin_dist_xy : advance_ed_ratio) // Use the fixed ratio, if set
+        * (block->nominal_speed / (float)block->nominal_rate)
+        * axis_steps_per_mm[E_AXIS_N] * 256.0
+      );
+      block->max_adv_steps = (block->nominal_rate * block->abs_adv_steps_multiplier8) >> 17;
+    }
+
+  #endif // LIN_ADVANCE
+
   // Compute and limit the acceleration rate for the trapezoid generator.
   const float steps_per_mm = block->step_event_count * inverse_millimeters;
   uint32_t accel;
@@ -1201,6 +1304,15 @@ void Planner::_buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const
       LIMIT_ACCEL_FLOAT(Z_AXIS, 0);
       LIMIT_ACCEL_FLOAT(E_AXIS, ACCEL_IDX);
     }
+
+    #if ENABLED(LIN_ADVANCE)
+      // Limit acceleration so the advance steps are never added faster than the E jerk.
+      // The stepper takes them along with the linear E steps, at most one per step event.
+      if (block->use_advance_lead) {
+        const float max_accel = max_jerk[E_AXIS] * axis_steps_per_mm[E_AXIS_N] * 131072.0 / block->abs_adv_steps_multiplier8;
+        if (accel > max_accel) accel = max_accel;
+      }
+    #endif
   }
   block->acceleration_steps_per_s2 = accel;
   block->acceleration = accel / steps_per_mm;
@@ -1358,35 +1470,6 @@ void Planner::_buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const
   previous_nominal_speed = block->nominal_speed;
   previous_safe_speed = safe_speed;
 
-  #if ENABLED(LIN_ADVANCE)
-    /**
-     *
-     * Use LIN_ADVANCE for blocks if all these are true:
-     *
-     * esteps && (block->steps[X_AXIS] || block->steps[Y_AXIS]) : This is a print move
-     *
-     * extruder_advance_k                 : There is an advance factor set.
-     *
-     * esteps != block->step_event_count  : A problem occurs if the move before a retract is too small.
-     *                                      In that case, the retract and move will be executed together.
-     *                                      This leads to too many advance steps due to a huge e_acceleration.
-     *                                      The math is good, but we must avoid retract moves with advance!
-     * lin_dist_e > 0                       : Extruder is running forward (e.g., for "Wipe while retracting" (Slic3r) or "Combing" (Cura) moves)
-     */
-    block->use_advance_lead =  esteps && (block->steps[X_AXIS] || block->steps[Y_AXIS])
-                            && extruder_advance_k
-                            && (uint32_t)esteps != block->step_event_count
-                            && lin_dist_e > 0;
-    if (block->use_advance_lead)
-      block->abs_adv_steps_multiplier8 = LROUND(
-        extruder_advance_k
-        * (UNEAR_ZERO(advance_ed_ratio) ? lin_dist_e / lin_dist_xy : advance_ed_ratio) // Use the fixed ratio, if set
-        * (block->nominal_speed / (float)block->nominal_rate)
-        * axis_steps_per_mm[E_AXIS_N] * 256.0
-      );
-
-  #endif // LIN_ADVANCE
-
   const float bnsr = 1.0 / block->nominal_speed;
   calculate_trapezoid_for_block(block, block->entry_speed * bnsr, safe_speed * bnsr);
 
@@ -1401,6 +1484,44 @@ void Planner::_buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const
 
 } // _buffer_steps()
 
+#if ENABLED(GRADIENT_MIX)
+
+  /**
+   * Get the proportions of the gradient's start and end tools.
+   * The mix is updated for the next block.
+   */
+  void Planner::refresh_gradient() {
+    for (uint8_t i = 0; i < MIXING_STEPPERS; i++) {
+      const float start = RECIPROCAL(mixing_virtual_tool_mix[gradient.start_vtool][i]),
+                  end = RECIPROCAL(mixing_virtual_tool_mix[gradient.end_vtool][i]);
+      gradient_start_mix[i] = start;
+      gradient_delta_mix[i] = end - start;
+    }
+    gradient_valid = false;
+  }
+
+  /**
+   * Set the mix for the next moves at the given logical height, before
+   * leveling, if the gradient is on for the selected tool. Moves at the
+   * same height share the last mix, so the math is done about once per layer.
+   */
+  void Planner::update_gradient_mix(const float &z) {
+    if (!gradient.enabled || selected_vtool != gradient.vtool_index) return;
+    if (gradient_valid && z == gradient_last_z) return;
+    gradient_valid = true;
+    gradient_last_z = z;
+
+    float t;
+    if (z <= gradient.start_z) t = 0.0;
+    else if (z >= gradient.end_z) t = 1.0;
+    else t = (z - gradient.start_z) / (gradient.end_z - gradient.start_z);
+
+    for (uint8_t i = 0; i < MIXING_STEPPERS; i++)
+      mixing_factor[i] = RECIPROCAL(gradient_start_mix[i] + gradient_delta_mix[i] * t);
+  }
+
+#endif // GRADIENT_MIX
+
 /**
  * Planner::buffer_segment
  *
@@ -1413,6 +1534,10 @@ void Planner::_buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const
  *  extruder  - target extruder
  */
 void Planner::buffer_segment(const float &a, const float &b, const float &c, const float &e, const float &fr_mm_s, const uint8_t extruder) {
+  #if ENABLED(MOVE_COALESCING)
+    flush_coalesced_line(); // The held move comes first
+  #endif
+
   // When changing extruders recalculate steps corresponding to the E position
   #if ENABLED(DISTINCT_E_FACTORS)
     if (last_extruder != extruder && axis_steps_per_mm[E_AXIS_N] != axis_steps_per_mm[E_AXIS + last_extruder]) {
@@ -1539,6 +1664,77 @@ void Planner::buffer_segment(const float &a, const float &b, const float &c, con
   #endif
 } // buffer_segment()
 
+#if ENABLED(MOVE_COALESCING)
+
+  /**
+   * Planner::buffer_line_coalesced
+   *
+   * Merge a move into the held move if it continues in nearly the same direction
+   * at the same feedrate and extrusion per mm, and the merged line stays within
+   * MOVE_COALESCE_DEVIATION of every point it replaces. Otherwise send the held
+   * move to the planner and hold this one instead.
+   *
+   *  from, to  - start and end of the move in mm
+   *  fr_mm_s   - (target) speed of the move
+   *  extruder  - target extruder
+   */
+  void Planner::buffer_line_coalesced(const float (&from)[XYZE], const float (&to)[XYZE], const float &fr_mm_s, const uint8_t extruder) {
+    if (coalesce_pending && fr_mm_s == coalesce_fr_mm_s && extruder == coalesce_extruder) {
+      float u[XYZ], v[XYZ];
+      LOOP_XYZ(i) {
+        u[i] = coalesce_end[i] - coalesce_start[i];  // The held move
+        v[i] = to[i] - coalesce_end[i];              // The new move
+      }
+      const float lu = SQRT(sq(u[X_AXIS]) + sq(u[Y_AXIS]) + sq(u[Z_AXIS])),
+                  lv = SQRT(sq(v[X_AXIS]) + sq(v[Y_AXIS]) + sq(v[Z_AXIS])),
+                  dot = u[X_AXIS] * v[X_AXIS] + u[Y_AXIS] * v[Y_AXIS] + u[Z_AXIS] * v[Z_AXIS];
+
+      // Direction change within MOVE_COALESCE_MAX_ANGLE, up to MOVE_COALESCE_MAX_LENGTH in all
+      if (lv > 0.0 && lu + lv <= (MOVE_COALESCE_MAX_LENGTH) && dot >= cos(RADIANS(MOVE_COALESCE_MAX_ANGLE)) * lu * lv) {
+        const float eu = coalesce_end[E_AXIS] - coalesce_start[E_AXIS],
+                    ev = to[E_AXIS] - coalesce_end[E_AXIS];
+
+        // Extrusion per mm within MOVE_COALESCE_E_RATIO of the held move
+        if (FABS(ev * lu - eu * lv) <= (MOVE_COALESCE_E_RATIO) * FABS(eu) * lv) {
+          // Every replaced point lies within the accumulated deviation of the held
+          // line, which in turn lies within the old end point's distance of the new line.
+          const float cx = u[Y_AXIS] * v[Z_AXIS] - u[Z_AXIS] * v[Y_AXIS],
+                      cy = u[Z_AXIS] * v[X_AXIS] - u[X_AXIS] * v[Z_AXIS],
+                      cz = u[X_AXIS] * v[Y_AXIS] - u[Y_AXIS] * v[X_AXIS],
+                      lc = SQRT(sq(u[X_AXIS] + v[X_AXIS]) + sq(u[Y_AXIS] + v[Y_AXIS]) + sq(u[Z_AXIS] + v[Z_AXIS])),
+                      deviation = coalesce_deviation + SQRT(sq(cx) + sq(cy) + sq(cz)) / lc;
+          if (deviation <= MOVE_COALESCE_DEVIATION) {
+            coalesce_deviation = deviation;
+            COPY(coalesce_end, to);
+            return;
+          }
+        }
+      }
+    }
+
+    flush_coalesced_line();
+    COPY(coalesce_start, from);
+    COPY(coalesce_end, to);
+    coalesce_fr_mm_s = fr_mm_s;
+    coalesce_extruder = extruder;
+    coalesce_deviation = 0.0;
+    coalesce_pending = true;
+  }
+
+  /**
+   * Send the held move, if any, to the planner
+   */
+  void Planner::flush_coalesced_line() {
+    if (!coalesce_pending) return;
+    coalesce_pending = false;
+    #if ENABLED(GRADIENT_MIX)
+      update_gradient_mix(LOGICAL_Z_POSITION(coalesce_end[Z_AXIS]));
+    #endif
+    buffer_line(coalesce_end[X_AXIS], coalesce_end[Y_AXIS], coalesce_end[Z_AXIS], coalesce_end[E_AXIS], coalesce_fr_mm_s, coalesce_extruder);
+  }
+
+#endif // MOVE_COALESCING
+
 /**
  * Directly set the planner XYZ position (and stepper positions)
  * converting mm (or angles for SCARA) into steps.
@@ -1547,6 +1743,9 @@ void Planner::buffer_segment(const float &a, const float &b, const float &c, con
  */
 
 void Planner::_set_position_mm(const float &a, const float &b, const float &c, const float &e) {
+  #if ENABLED(MOVE_COALESCING)
+    flush_coalesced_line(); // The held move ends at the old position
+  #endif
   #if ENABLED(DISTINCT_E_FACTORS)
     #define _EINDEX (E_AXIS + active_extruder)
     last_extruder = active_extruder;
@@ -1603,6 +1802,9 @@ void Planner::sync_from_steppers() {
  * Setters for planner position (also setting stepper position).
  */
 void Planner::set_position_mm(const AxisEnum axis, const float &v) {
+  #if ENABLED(MOVE_COALESCING)
+    flush_coalesced_line(); // The held move ends at the old position
+  #endif
   #if ENABLED(DISTINCT_E_FACTORS)
     const uint8_t axis_index = axis + (axis == E_AXIS ? active_extruder : 0);
     last_extruder = active_extruder;
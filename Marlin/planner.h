@@ -99,7 +99,9 @@ typedef struct {
   // Advance extrusion
   #if ENABLED(LIN_ADVANCE)
     bool use_advance_lead;
-    uint32_t abs_adv_steps_multiplier8; // Factorised by 2^8 to avoid float
+    uint32_t abs_adv_steps_multiplier8;     // Advance steps are (step rate * multiplier) >> 17, to avoid float
+    uint16_t max_adv_steps,                 // Advance steps at the nominal rate
+             final_adv_steps;               // Advance steps at the final rate
   #endif
 
   // Fields used by the motion planner to manage acceleration
@@ -129,6 +131,16 @@ typedef struct {
 
 #define BLOCK_MOD(n) ((n)&(BLOCK_BUFFER_SIZE-1))
 
+#if ENABLED(GRADIENT_MIX)
+  typedef struct {
+    bool enabled;                           // M166 S - Use the gradient for its virtual tool
+    uint8_t start_vtool,                    // M166 I - Virtual tool with the mix at start_z
+            end_vtool,                      // M166 J - Virtual tool with the mix at end_z
+            vtool_index;                    // M166 T - Virtual tool that prints the gradient
+    float start_z, end_z;                   // M166 A Z - Height range of the gradient
+  } gradient_t;
+#endif
+
 class Planner {
   public:
 
@@ -196,6 +208,10 @@ class Planner {
                    lin_dist_xy, lin_dist_e;
     #endif
 
+    #if ENABLED(GRADIENT_MIX)
+      static gradient_t gradient;           // Initialized by settings.load()
+    #endif
+
     #if ENABLED(SKEW_CORRECTION)
       #if ENABLED(SKEW_CORRECTION_GCODE)
         static float xy_skew_factor;
@@ -256,10 +272,31 @@ class Planner {
       static uint32_t axis_segment_time_us[2][3];
     #endif
 
-    #if ENABLED(ULTRA_LCD)
+    #if HAS_BLOCK_BUFFER_RUNTIME
       volatile static uint32_t block_buffer_runtime_us; //Theoretical block buffer runtime in µs
     #endif
 
+    #if ENABLED(MOVE_COALESCING)
+      static bool coalesce_pending;           // A move is held back for merging
+      static float coalesce_start[XYZE],      // Start of the held move
+                   coalesce_end[XYZE],        // End of the held move
+                   coalesce_fr_mm_s,          // Feedrate of the held move
+                   coalesce_deviation;        // Furthest any merged point may be from the held move
+      static uint8_t coalesce_extruder;
+    #endif
+
+    #if ENABLED(ADAPTIVE_SLOWDOWN)
+      static uint32_t last_arrival_us,    // Time the previous move was handed to the planner
+                      arrival_interval_us; // Running average of the time between incoming moves
+    #endif
+
+    #if ENABLED(GRADIENT_MIX)
+      static bool gradient_valid;                   // The mix is up to date for gradient_last_z
+      static float gradient_last_z,
+                   gradient_start_mix[MIXING_STEPPERS], // Proportions at start_z
+                   gradient_delta_mix[MIXING_STEPPERS]; // Change in proportions up to end_z
+    #endif
+
   public:
 
     /**
@@ -288,6 +325,11 @@ class Planner {
     // Manage fans, paste pressure, etc.
     static void check_axes_activity();
 
+    #if ENABLED(GRADIENT_MIX)
+      // Call after changing the gradient, the virtual tools, or the selected tool
+      static void refresh_gradient();
+    #endif
+
     /**
      * Number of moves currently in the planner
      */
@@ -415,6 +457,10 @@ class Planner {
      */
     static void _buffer_steps(const int32_t (&target)[XYZE], float fr_mm_s, const uint8_t extruder);
 
+    #if ENABLED(GRADIENT_MIX)
+      static void update_gradient_mix(const float &z);
+    #endif
+
     /**
      * Planner::buffer_segment
      *
@@ -473,6 +519,18 @@ class Planner {
       #endif
     }
 
+    #if ENABLED(MOVE_COALESCING)
+      /**
+       * Hold back a Cartesian move (from, to in mm) so that following moves
+       * along the same line can be merged into a single block.
+       * Any other move, or setting the planner position, flushes the held
+       * move first.
+       */
+      static void buffer_line_coalesced(const float (&from)[XYZE], const float (&to)[XYZE], const float &fr_mm_s, const uint8_t extruder);
+      static void flush_coalesced_line();
+      FORCE_INLINE static void discard_coalesced_line() { coalesce_pending = false; }
+    #endif
+
     /**
      * Set the planner.position and individual stepper positions.
      * Used by G92, G28, G29, and other procedures.
@@ -530,21 +588,21 @@ class Planner {
     static block_t* get_current_block() {
       if (blocks_queued()) {
         block_t * const block = &block_buffer[block_buffer_tail];
-        #if ENABLED(ULTRA_LCD)
+        #if HAS_BLOCK_BUFFER_RUNTIME
           block_buffer_runtime_us -= block->segment_time_us; // We can't be sure how long an active block will take, so don't count it.
         #endif
         SBI(block->flag, BLOCK_BIT_BUSY);
         return block;
       }
       else {
-        #if ENABLED(ULTRA_LCD)
+        #if HAS_BLOCK_BUFFER_RUNTIME
           clear_block_buffer_runtime(); // paranoia. Buffer is empty now - so reset accumulated time to zero.
         #endif
         return NULL;
       }
     }
 
-    #if ENABLED(ULTRA_LCD)
+    #if HAS_BLOCK_BUFFER_RUNTIME
 
       static uint16_t block_buffer_runtime() {
         CRITICAL_SECTION_START
@@ -565,6 +623,13 @@ class Planner {
         CRITICAL_SECTION_END
       }
 
+      #if ENABLED(PLANNER_TIME_WATERMARK)
+        /**
+         * Is there room in the buffer and less than the target motion time queued?
+         */
+        static bool needs_moves() { return !is_full() && block_buffer_runtime() < (PLANNER_TARGET_QUEUE_MS); }
+      #endif
+
     #endif
 
     #if ENABLED(AUTOTEMP)
@@ -62,6 +62,10 @@
   #include <SPI.h>
 #endif
 
+#if ENABLED(ISR_PROFILING)
+  #include "isr_profiler.h"
+#endif
+
 Stepper stepper; // Singleton
 
 // public:
@@ -102,35 +106,41 @@ long Stepper::counter_X = 0,
 
 volatile uint32_t Stepper::step_events_completed = 0; // The number of step events executed in the current block
 
+#if HAS_STEPPER_SCHEDULER
+  uint16_t Stepper::nextMainISR = 0;
+#endif
+
 #if ENABLED(LIN_ADVANCE)
+  int16_t Stepper::la_steps = 0,
+          Stepper::current_adv_steps = 0;
+  int8_t Stepper::la_dir = 0;
+#endif
 
-  constexpr uint16_t ADV_NEVER = 65535;
+#if ENABLED(INPUT_SHAPING)
 
-  uint16_t Stepper::nextMainISR = 0,
-           Stepper::nextAdvanceISR = ADV_NEVER,
-           Stepper::eISR_Rate = ADV_NEVER;
+  constexpr uint16_t SHAPING_NEVER = 65535;
 
-  volatile int Stepper::e_steps[E_STEPPERS];
-  int Stepper::final_estep_rate,
-      Stepper::current_estep_rate[E_STEPPERS],
-      Stepper::current_adv_steps[E_STEPPERS];
+  #define SHAPING_NEXT(I) (((I) + 1) & (SHAPING_BUFFER_SIZE - 1))
+  #define SHAPING_PREV(I) (((I) + SHAPING_BUFFER_SIZE - 1) & (SHAPING_BUFFER_SIZE - 1))
 
-  /**
-   * See https://github.com/MarlinFirmware/Marlin/issues/5699#issuecomment-309264382
-   *
-   * This fix isn't perfect and may lose steps - but better than locking up completely
-   * in future the planner should slow down if advance stepping rate would be too high
-   */
-  FORCE_INLINE uint16_t adv_rate(const int steps, const uint16_t timer, const uint8_t loops) {
-    if (steps) {
-      const uint16_t rate = (timer * loops) / abs(steps);
-      //return constrain(rate, 1, ADV_NEVER - 1)
-      return rate ? rate : 1;
-    }
-    return ADV_NEVER;
-  }
+  float Stepper::shaping_frequency[2], Stepper::shaping_zeta[2]; // Initialized by settings.load()
+  ShaperType Stepper::shaping_type[2];
+
+  uint32_t Stepper::shaping_ticks = 0;
+  uint16_t Stepper::shaping_gain[2] = { 256, 256 },
+           Stepper::shaping_window = 1;
+  int16_t Stepper::shaping_frac[2] = { 0 };
+  int8_t Stepper::shaping_dir[2] = { 0 };
+  shaping_event_t Stepper::shaping_queue[SHAPING_BUFFER_SIZE];
+  uint8_t Stepper::shaping_head = 0,
+          Stepper::shaping_echoes = 0;
+  shaping_echo_t Stepper::shaping_echo[4];
+  bool Stepper::shaping_suspended = false;
+
+  // The shaping clock, in units of 16 timer ticks
+  FORCE_INLINE uint16_t shaping_now(const uint32_t ticks) { return (uint16_t)(ticks >> 4); }
 
-#endif // LIN_ADVANCE
+#endif // INPUT_SHAPING
 
 long Stepper::acceleration_time, Stepper::deceleration_time;
 
@@ -148,6 +158,17 @@ uint16_t Stepper::OCR1A_nominal,
 
 volatile long Stepper::endstops_trigsteps[XYZ];
 
+#if ENABLED(BABYSTEPPING)
+  uint8_t Stepper::babystep_axes = 0,
+          Stepper::babystep_dirs;
+  uint16_t Stepper::babystep_ticks = 0;
+#endif
+
+#if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+  volatile bool Stepper::edge_captured = false;
+  long Stepper::edge_position[XYZ];
+#endif
+
 #if ENABLED(X_DUAL_ENDSTOPS) || ENABLED(Y_DUAL_ENDSTOPS) || ENABLED(Z_DUAL_ENDSTOPS)
   #define LOCKED_X_MOTOR  locked_x_motor
   #define LOCKED_Y_MOTOR  locked_y_motor
@@ -172,26 +193,27 @@ volatile long Stepper::endstops_trigsteps[XYZ];
     }
 #endif
 
-#if ENABLED(X_DUAL_STEPPER_DRIVERS)
+#if ENABLED(DUAL_X_CARRIAGE)
+  // In mirrored mode X2 runs opposite to X in the same ISR pass
+  #define X_APPLY_DIR(v,ALWAYS) \
+    if (extruder_duplication_enabled || ALWAYS) { \
+      X_DIR_WRITE(v); \
+      X2_DIR_WRITE(mirrored_duplication_mode ? !(v) : (v)); \
+    } \
+    else { \
+      if (current_block->active_extruder) X2_DIR_WRITE(v); else X_DIR_WRITE(v); \
+    }
+  #define X_APPLY_STEP(v,ALWAYS) \
+    if (extruder_duplication_enabled || ALWAYS) { \
+      X_STEP_WRITE(v); \
+      X2_STEP_WRITE(v); \
+    } \
+    else { \
+      if (current_block->active_extruder) X2_STEP_WRITE(v); else X_STEP_WRITE(v); \
+    }
+#elif ENABLED(X_DUAL_STEPPER_DRIVERS)
   #define X_APPLY_DIR(v,Q) do{ X_DIR_WRITE(v); X2_DIR_WRITE((v) != INVERT_X2_VS_X_DIR); }while(0)
-  #if ENABLED(DUAL_X_CARRIAGE)
-    #define X_APPLY_DIR(v,ALWAYS) \
-      if (extruder_duplication_enabled || ALWAYS) { \
-        X_DIR_WRITE(v); \
-        X2_DIR_WRITE(v); \
-      } \
-      else { \
-        if (current_block->active_extruder) X2_DIR_WRITE(v); else X_DIR_WRITE(v); \
-      }
-    #define X_APPLY_STEP(v,ALWAYS) \
-      if (extruder_duplication_enabled || ALWAYS) { \
-        X_STEP_WRITE(v); \
-        X2_STEP_WRITE(v); \
-      } \
-      else { \
-        if (current_block->active_extruder) X2_STEP_WRITE(v); else X_STEP_WRITE(v); \
-      }
-  #elif ENABLED(X_DUAL_ENDSTOPS)
+  #if ENABLED(X_DUAL_ENDSTOPS)
     #define X_APPLY_STEP(v,Q) DUAL_ENDSTOP_APPLY_STEP(X,v)
   #else
     #define X_APPLY_STEP(v,Q) do{ X_STEP_WRITE(v); X2_STEP_WRITE(v); }while(0)
@@ -328,17 +350,27 @@ void Stepper::set_directions() {
       count_direction[AXIS ##_AXIS] = 1; \
     }
 
-  #if HAS_X_DIR
-    SET_STEP_DIR(X); // A
-  #endif
-  #if HAS_Y_DIR
-    SET_STEP_DIR(Y); // B
+  #if ENABLED(INPUT_SHAPING)
+    // Shaped axes set their DIR pins with each step
+    #define SET_COUNT_DIR(AXIS) count_direction[AXIS ##_AXIS] = motor_direction(AXIS ##_AXIS) ? -1 : 1
+    SET_COUNT_DIR(X); // A
+    SET_COUNT_DIR(Y); // B
+  #else
+    #if HAS_X_DIR
+      SET_STEP_DIR(X); // A
+    #endif
+    #if HAS_Y_DIR
+      SET_STEP_DIR(Y); // B
+    #endif
   #endif
   #if HAS_Z_DIR
     SET_STEP_DIR(Z); // C
   #endif
 
-  #if DISABLED(LIN_ADVANCE)
+  #if ENABLED(LIN_ADVANCE)
+    // E DIR is set with each step, as advance steps may go against the move
+    count_direction[E_AXIS] = motor_direction(E_AXIS) ? -1 : 1;
+  #else
     if (motor_direction(E_AXIS)) {
       REV_E_DIR();
       count_direction[E_AXIS] = -1;
@@ -347,11 +379,20 @@ void Stepper::set_directions() {
       NORM_E_DIR();
       count_direction[E_AXIS] = 1;
     }
-  #endif // !LIN_ADVANCE
+  #endif
 }
 
 #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
   extern volatile uint8_t e_hit;
+  extern bool e_poll;
+#endif
+
+#if ENABLED(BABYSTEPPING)
+  #define BABYSTEP_TICKS ((F_CPU) / 8 / (BABYSTEP_MAX_RATE))  // Timer1 ticks between babysteps
+
+  FORCE_INLINE static bool babysteps_pending() {
+    return thermalManager.babystepsTodo[X_AXIS] || thermalManager.babystepsTodo[Y_AXIS] || thermalManager.babystepsTodo[Z_AXIS];
+  }
 #endif
 
 /**
@@ -369,13 +410,34 @@ void Stepper::set_directions() {
  *  4000   500  Hz - init rate
  */
 ISR(TIMER1_COMPA_vect) {
-  #if ENABLED(LIN_ADVANCE)
-    Stepper::advance_isr_scheduler();
+  #if ENABLED(BABYSTEPPING)
+    const uint16_t elapsed = OCR1A;     // Timer1 restarted from 0 at this compare match
+    Stepper::babystep_finish();
+  #endif
+  #if ENABLED(INPUT_SHAPING)
+    Stepper::shaping_isr_scheduler();
   #else
     Stepper::isr();
+    #if ENABLED(ISR_PROFILING)
+      // Timer1 restarted from 0 at the compare match that got us here
+      isr_profiler.record(isr_profiler.stepper_isr, TCNT1);
+    #endif
+  #endif
+  #if ENABLED(BABYSTEPPING)
+    Stepper::babystep_start(elapsed);
   #endif
 }
 
+// Don't run the ISR faster than possible
+#if ENABLED(ISR_PROFILING)
+  #define LIMIT_OCR1A() do{ \
+    const uint16_t ocr_min = TCNT1 + 16; \
+    if (OCR1A < ocr_min) { OCR1A = ocr_min; isr_profiler.late_compare(); } \
+  }while(0)
+#else
+  #define LIMIT_OCR1A() NOLESS(OCR1A, TCNT1 + 16)
+#endif
+
 #define _ENABLE_ISRs() do { cli(); if (thermalManager.in_temp_isr) CBI(TIMSK0, OCIE0B); else SBI(TIMSK0, OCIE0B); ENABLE_STEPPER_DRIVER_INTERRUPT(); } while(0)
 
 void Stepper::isr() {
@@ -385,7 +447,7 @@ void Stepper::isr() {
   #define ENDSTOP_NOMINAL_OCR_VAL 3000 // Check endstops every 1.5ms to guarantee two stepper ISRs within 5ms for BLTouch
   #define OCR_VAL_TOLERANCE       1000 // First max delay is 2.0ms, last min delay is 0.5ms, all others 1.5ms
 
-  #if DISABLED(LIN_ADVANCE)
+  #if !HAS_STEPPER_SCHEDULER
     // Disable Timer0 ISRs and enable global ISR again to capture UART events (incoming chars)
     CBI(TIMSK0, OCIE0B); // Temperature ISR
     DISABLE_STEPPER_DRIVER_INTERRUPT();
@@ -417,7 +479,7 @@ void Stepper::isr() {
       ocr_val = step_remaining <= ENDSTOP_NOMINAL_OCR_VAL ? step_remaining : ENDSTOP_NOMINAL_OCR_VAL;
       step_remaining -= ocr_val;
       _NEXT_ISR(ocr_val);
-      NOLESS(OCR1A, TCNT1 + 16);
+      LIMIT_OCR1A();
       _ENABLE_ISRs(); // re-enable ISRs
       return;
     }
@@ -448,8 +510,14 @@ void Stepper::isr() {
 
   // If there is no current block, attempt to pop one from the buffer
   if (!current_block) {
+    current_block = planner.get_current_block();
+
+    #if ENABLED(ISR_PROFILING)
+      isr_profiler.block_check(current_block != NULL);
+    #endif
+
     // Anything in the buffer?
-    if ((current_block = planner.get_current_block())) {
+    if (current_block) {
       trapezoid_generator_reset();
 
       // Initialize Bresenham counters to 1/2 the ceiling
@@ -465,6 +533,7 @@ void Stepper::isr() {
       #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
         e_hit = 2; // Needed for the case an endstop is already triggered before the new move begins.
                    // No 'change' can be detected.
+        release_endstop_edge();
       #endif
 
       #if ENABLED(Z_LATE_ENABLE)
@@ -477,6 +546,10 @@ void Stepper::isr() {
       #endif
     }
     else {
+      #if ENABLED(BABYSTEPPING)
+        // Keep up the babystep rate while idle
+        if (babysteps_pending()) _NEXT_ISR(max(BABYSTEP_TICKS, 200)); else
+      #endif
       _NEXT_ISR(2000); // Run at slow speed - 1 KHz
       _ENABLE_ISRs(); // re-enable ISRs
       return;
@@ -485,9 +558,9 @@ void Stepper::isr() {
 
   // Update endstops state, if enabled
   #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
-    if (e_hit && ENDSTOPS_ENABLED) {
+    if ((e_hit || e_poll) && ENDSTOPS_ENABLED) {
       endstops.update();
-      e_hit--;
+      if (e_hit && !--e_hit) release_endstop_edge();
     }
   #else
     if (ENDSTOPS_ENABLED) endstops.update();
@@ -495,30 +568,30 @@ void Stepper::isr() {
 
   // Take multiple steps per interrupt (For high speed moves)
   bool all_steps_done = false;
+
+  #if ENABLED(INPUT_SHAPING)
+    int8_t shaped_steps[2] = { 0 };
+  #endif
+
   for (uint8_t i = step_loops; i--;) {
     #if ENABLED(LIN_ADVANCE)
 
+      // Queue the linear E step with the advance steps. One of them is taken below.
       counter_E += current_block->steps[E_AXIS];
       if (counter_E > 0) {
         counter_E -= current_block->step_event_count;
-        #if DISABLED(MIXING_EXTRUDER)
-          // Don't step E here for mixing extruder
-          count_position[E_AXIS] += count_direction[E_AXIS];
-          motor_direction(E_AXIS) ? --e_steps[TOOL_E_INDEX] : ++e_steps[TOOL_E_INDEX];
-        #endif
+        count_position[E_AXIS] += count_direction[E_AXIS];
+        la_steps += count_direction[E_AXIS];
       }
 
-      #if ENABLED(MIXING_EXTRUDER)
-        // Step mixing steppers proportionally
-        const bool dir = motor_direction(E_AXIS);
-        MIXING_STEPPERS_LOOP(j) {
-          counter_m[j] += current_block->steps[E_AXIS];
-          if (counter_m[j] > 0) {
-            counter_m[j] -= current_block->mix_event_count[j];
-            dir ? --e_steps[j] : ++e_steps[j];
-          }
+      // Set E DIR ahead of the pulse if the pending steps changed direction
+      if (la_steps) {
+        const int8_t dir = la_steps > 0 ? 1 : -1;
+        if (dir != la_dir) {
+          la_dir = dir;
+          if (dir > 0) NORM_E_DIR(); else REV_E_DIR();
         }
-      #endif
+      }
 
     #endif // LIN_ADVANCE
 
@@ -531,6 +604,15 @@ void Stepper::isr() {
       _COUNTER(AXIS) += current_block->steps[_AXIS(AXIS)]; \
       if (_COUNTER(AXIS) > 0) { _APPLY_STEP(AXIS)(!_INVERT_STEP_PIN(AXIS),0); }
 
+    // Advance the Bresenham counter; count the step for the shaper to take
+    #define SHAPED_STEP(AXIS) \
+      _COUNTER(AXIS) += current_block->steps[_AXIS(AXIS)]; \
+      if (_COUNTER(AXIS) > 0) { \
+        _COUNTER(AXIS) -= current_block->step_event_count; \
+        count_position[_AXIS(AXIS)] += count_direction[_AXIS(AXIS)]; \
+        shaped_steps[_AXIS(AXIS)] += count_direction[_AXIS(AXIS)]; \
+      }
+
     // Stop an active pulse, reset the Bresenham counter, update the position
     #define PULSE_STOP(AXIS) \
       if (_COUNTER(AXIS) > 0) { \
@@ -551,22 +633,22 @@ void Stepper::isr() {
      * Delays under 20 cycles (1.25µs) will be very accurate, using NOPs.
      * Longer delays use a loop. The resolution is 8 cycles.
      */
-    #if HAS_X_STEP
+    #if HAS_X_STEP && DISABLED(INPUT_SHAPING)
       #define _CYCLE_APPROX_1 5
     #else
       #define _CYCLE_APPROX_1 0
     #endif
-    #if ENABLED(X_DUAL_STEPPER_DRIVERS)
+    #if ENABLED(X_DUAL_STEPPER_DRIVERS) && DISABLED(INPUT_SHAPING)
       #define _CYCLE_APPROX_2 _CYCLE_APPROX_1 + 4
     #else
       #define _CYCLE_APPROX_2 _CYCLE_APPROX_1
     #endif
-    #if HAS_Y_STEP
+    #if HAS_Y_STEP && DISABLED(INPUT_SHAPING)
       #define _CYCLE_APPROX_3 _CYCLE_APPROX_2 + 5
     #else
       #define _CYCLE_APPROX_3 _CYCLE_APPROX_2
     #endif
-    #if ENABLED(Y_DUAL_STEPPER_DRIVERS)
+    #if ENABLED(Y_DUAL_STEPPER_DRIVERS) && DISABLED(INPUT_SHAPING)
       #define _CYCLE_APPROX_4 _CYCLE_APPROX_3 + 4
     #else
       #define _CYCLE_APPROX_4 _CYCLE_APPROX_3
@@ -581,14 +663,10 @@ void Stepper::isr() {
     #else
       #define _CYCLE_APPROX_6 _CYCLE_APPROX_5
     #endif
-    #if DISABLED(LIN_ADVANCE)
-      #if ENABLED(MIXING_EXTRUDER)
-        #define _CYCLE_APPROX_7 _CYCLE_APPROX_6 + (MIXING_STEPPERS) * 6
-      #else
-        #define _CYCLE_APPROX_7 _CYCLE_APPROX_6 + 5
-      #endif
+    #if ENABLED(MIXING_EXTRUDER)
+      #define _CYCLE_APPROX_7 _CYCLE_APPROX_6 + (MIXING_STEPPERS) * 6
     #else
-      #define _CYCLE_APPROX_7 _CYCLE_APPROX_6
+      #define _CYCLE_APPROX_7 _CYCLE_APPROX_6 + 5
     #endif
 
     #define CYCLES_EATEN_XYZE _CYCLE_APPROX_7
@@ -606,18 +684,25 @@ void Stepper::isr() {
       uint32_t pulse_start = TCNT0;
     #endif
 
-    #if HAS_X_STEP
-      PULSE_START(X);
-    #endif
-    #if HAS_Y_STEP
-      PULSE_START(Y);
+    #if ENABLED(INPUT_SHAPING)
+      SHAPED_STEP(X);
+      SHAPED_STEP(Y);
+    #else
+      #if HAS_X_STEP
+        PULSE_START(X);
+      #endif
+      #if HAS_Y_STEP
+        PULSE_START(Y);
+      #endif
     #endif
     #if HAS_Z_STEP
       PULSE_START(Z);
     #endif
 
-    // For non-advance use linear interpolation for E also
-    #if DISABLED(LIN_ADVANCE)
+    // Take one pending E step, or use linear interpolation for E also
+    #if ENABLED(LIN_ADVANCE)
+      if (la_steps) E_STEP_WRITE(!INVERT_E_STEP_PIN);
+    #else
       #if ENABLED(MIXING_EXTRUDER)
         // Keep updating the single E axis
         counter_E += current_block->steps[E_AXIS];
@@ -641,17 +726,24 @@ void Stepper::isr() {
       DELAY_NOPS(EXTRA_CYCLES_XYZE);
     #endif
 
-    #if HAS_X_STEP
-      PULSE_STOP(X);
-    #endif
-    #if HAS_Y_STEP
-      PULSE_STOP(Y);
+    #if DISABLED(INPUT_SHAPING)
+      #if HAS_X_STEP
+        PULSE_STOP(X);
+      #endif
+      #if HAS_Y_STEP
+        PULSE_STOP(Y);
+      #endif
     #endif
     #if HAS_Z_STEP
       PULSE_STOP(Z);
     #endif
 
-    #if DISABLED(LIN_ADVANCE)
+    #if ENABLED(LIN_ADVANCE)
+      if (la_steps) {
+        la_steps -= la_dir;
+        E_STEP_WRITE(INVERT_E_STEP_PIN);
+      }
+    #else
       #if ENABLED(MIXING_EXTRUDER)
         // Always step the single E axis
         if (counter_E > 0) {
@@ -683,24 +775,11 @@ void Stepper::isr() {
 
   } // steps_loop
 
-  #if ENABLED(LIN_ADVANCE)
-
-    if (current_block->use_advance_lead) {
-      const int delta_adv_steps = current_estep_rate[TOOL_E_INDEX] - current_adv_steps[TOOL_E_INDEX];
-      current_adv_steps[TOOL_E_INDEX] += delta_adv_steps;
-      #if ENABLED(MIXING_EXTRUDER)
-        // Mixing extruders apply advance lead proportionally
-        MIXING_STEPPERS_LOOP(j)
-          e_steps[j] += delta_adv_steps * current_block->step_event_count / current_block->mix_event_count[j];
-      #else
-        // For most extruders, advance the single E stepper
-        e_steps[TOOL_E_INDEX] += delta_adv_steps;
-      #endif
-    }
-    // If we have esteps to execute, fire the next advance_isr "now"
-    if (e_steps[TOOL_E_INDEX]) nextAdvanceISR = 0;
-
-  #endif // LIN_ADVANCE
+  #if ENABLED(INPUT_SHAPING)
+    // Take the first share of the X and Y steps and queue the rest
+    if (shaped_steps[X_AXIS] || shaped_steps[Y_AXIS])
+      shaping_enqueue(shaped_steps[X_AXIS], shaped_steps[Y_AXIS]);
+  #endif
 
   // Calculate new timer value
   if (step_events_completed <= (uint32_t)current_block->accelerate_until) {
@@ -720,18 +799,9 @@ void Stepper::isr() {
     acceleration_time += interval;
 
     #if ENABLED(LIN_ADVANCE)
-
-      if (current_block->use_advance_lead) {
-        #if ENABLED(MIXING_EXTRUDER)
-          MIXING_STEPPERS_LOOP(j)
-            current_estep_rate[j] = ((uint32_t)acc_step_rate * current_block->abs_adv_steps_multiplier8 * current_block->step_event_count / current_block->mix_event_count[j]) >> 17;
-        #else
-          current_estep_rate[TOOL_E_INDEX] = ((uint32_t)acc_step_rate * current_block->abs_adv_steps_multiplier8) >> 17;
-        #endif
-      }
-      eISR_Rate = adv_rate(e_steps[TOOL_E_INDEX], interval, step_loops);
-
-    #endif // LIN_ADVANCE
+      if (current_block->use_advance_lead)
+        advance_to(((uint32_t)acc_step_rate * current_block->abs_adv_steps_multiplier8) >> 17);
+    #endif
   }
   else if (step_events_completed > (uint32_t)current_block->decelerate_after) {
     uint16_t step_rate;
@@ -753,28 +823,16 @@ void Stepper::isr() {
     deceleration_time += interval;
 
     #if ENABLED(LIN_ADVANCE)
-
       if (current_block->use_advance_lead) {
-        #if ENABLED(MIXING_EXTRUDER)
-          MIXING_STEPPERS_LOOP(j)
-            current_estep_rate[j] = ((uint32_t)step_rate * current_block->abs_adv_steps_multiplier8 * current_block->step_event_count / current_block->mix_event_count[j]) >> 17;
-        #else
-          current_estep_rate[TOOL_E_INDEX] = ((uint32_t)step_rate * current_block->abs_adv_steps_multiplier8) >> 17;
-        #endif
+        const uint16_t adv_steps = ((uint32_t)step_rate * current_block->abs_adv_steps_multiplier8) >> 17;
+        advance_to(max(adv_steps, current_block->final_adv_steps));
       }
-      eISR_Rate = adv_rate(e_steps[TOOL_E_INDEX], interval, step_loops);
-
-    #endif // LIN_ADVANCE
+    #endif
   }
   else {
 
     #if ENABLED(LIN_ADVANCE)
-
-      if (current_block->use_advance_lead)
-        current_estep_rate[TOOL_E_INDEX] = final_estep_rate;
-
-      eISR_Rate = adv_rate(e_steps[TOOL_E_INDEX], OCR1A_nominal, step_loops_nominal);
-
+      if (current_block->use_advance_lead) advance_to(current_block->max_adv_steps);
     #endif
 
     SPLIT(OCR1A_nominal);  // split step into multiple ISRs if larger than ENDSTOP_NOMINAL_OCR_VAL
@@ -784,8 +842,8 @@ void Stepper::isr() {
     step_loops = step_loops_nominal;
   }
 
-  #if DISABLED(LIN_ADVANCE)
-    NOLESS(OCR1A, TCNT1 + 16);
+  #if !HAS_STEPPER_SCHEDULER
+    LIMIT_OCR1A();
   #endif
 
   // If current block is finished, reset pointer
@@ -793,146 +851,258 @@ void Stepper::isr() {
     current_block = NULL;
     planner.discard_current_block();
   }
-  #if DISABLED(LIN_ADVANCE)
+  #if !HAS_STEPPER_SCHEDULER
     _ENABLE_ISRs(); // re-enable ISRs
   #endif
 }
 
-#if ENABLED(LIN_ADVANCE)
-
-  #define CYCLES_EATEN_E (E_STEPPERS * 5)
-  #define EXTRA_CYCLES_E (STEP_PULSE_CYCLES - (CYCLES_EATEN_E))
+#if ENABLED(INPUT_SHAPING)
 
-  // Timer interrupt for E. e_steps is set in the main routine;
+  #define CYCLES_EATEN_SHAPING 10
+  #define EXTRA_CYCLES_SHAPING (STEP_PULSE_CYCLES - (CYCLES_EATEN_SHAPING))
 
-  void Stepper::advance_isr() {
+  #if EXTRA_CYCLES_SHAPING > 20
+    #define _SHAPING_WAIT() do{ \
+      const uint32_t pulse_start = TCNT0; \
+      while (EXTRA_CYCLES_SHAPING > (uint32_t)(TCNT0 - pulse_start) * (INT0_PRESCALER)) { /* nada */ } \
+    }while(0)
+  #elif EXTRA_CYCLES_SHAPING > 0
+    #define _SHAPING_WAIT() DELAY_NOPS(EXTRA_CYCLES_SHAPING)
+  #else
+    #define _SHAPING_WAIT() NOOP
+  #endif
 
-    nextAdvanceISR = eISR_Rate;
+  // Set DIR if needed and take one full step. Wait out the pulse and the gap after it.
+  #define SHAPING_PULSE(AXIS, D) do{ \
+    if (shaping_dir[_AXIS(AXIS)] != D) { \
+      shaping_dir[_AXIS(AXIS)] = D; \
+      AXIS ##_APPLY_DIR(D > 0 ? !INVERT_## AXIS ##_DIR : INVERT_## AXIS ##_DIR, false); \
+      _SHAPING_WAIT(); \
+    } \
+    AXIS ##_APPLY_STEP(!INVERT_## AXIS ##_STEP_PIN, 0); \
+    _SHAPING_WAIT(); \
+    AXIS ##_APPLY_STEP(INVERT_## AXIS ##_STEP_PIN, 0); \
+    _SHAPING_WAIT(); \
+  }while(0)
 
-    #if ENABLED(MK2_MULTIPLEXER)
-      // Even-numbered steppers are reversed
-      #define SET_E_STEP_DIR(INDEX) \
-        if (e_steps[INDEX]) E## INDEX ##_DIR_WRITE(e_steps[INDEX] < 0 ? !INVERT_E## INDEX ##_DIR ^ TEST(INDEX, 0) : INVERT_E## INDEX ##_DIR ^ TEST(INDEX, 0))
-    #else
-      #define SET_E_STEP_DIR(INDEX) \
-        if (e_steps[INDEX]) E## INDEX ##_DIR_WRITE(e_steps[INDEX] < 0 ? INVERT_E## INDEX ##_DIR : !INVERT_E## INDEX ##_DIR)
-    #endif
+  /**
+   * Move a shaped motor by a fraction of a step (1/256 step units).
+   * The motor takes a full step whenever it falls half a step behind.
+   */
+  void Stepper::shaping_move(const AxisEnum axis, const int16_t amount) {
+    int16_t &frac = shaping_frac[axis];
+    frac += amount;
+    while (frac > 127 || frac < -128) {
+      const int8_t dir = frac > 0 ? 1 : -1;
+      frac -= dir * 256;
+      if (axis == X_AXIS) {
+        #if HAS_X_STEP
+          SHAPING_PULSE(X, dir);
+        #endif
+      }
+      else {
+        #if HAS_Y_STEP
+          SHAPING_PULSE(Y, dir);
+        #endif
+      }
+    }
+  }
 
-    #define START_E_PULSE(INDEX) \
-      if (e_steps[INDEX]) E## INDEX ##_STEP_WRITE(!INVERT_E_STEP_PIN)
+  /**
+   * Called by the stepper ISR with the X and Y steps it just counted.
+   * The first impulse is taken now and the steps are queued for the echoes.
+   * Steps closer together than shaping_window share a queue event, so the
+   * queue only needs to cover the longest echo delay, not the step rate.
+   */
+  void Stepper::shaping_enqueue(const int8_t x, const int8_t y) {
+    if (shaping_suspended) {
+      if (x) shaping_move(X_AXIS, x * 256);
+      if (y) shaping_move(Y_AXIS, y * 256);
+      return;
+    }
 
-    #define STOP_E_PULSE(INDEX) \
-      if (e_steps[INDEX]) { \
-        e_steps[INDEX] < 0 ? ++e_steps[INDEX] : --e_steps[INDEX]; \
-        E## INDEX ##_STEP_WRITE(INVERT_E_STEP_PIN); \
-      }
+    if (x) shaping_move(X_AXIS, x * shaping_gain[X_AXIS]);
+    if (y) shaping_move(Y_AXIS, y * shaping_gain[Y_AXIS]);
 
-    SET_E_STEP_DIR(0);
-    #if E_STEPPERS > 1
-      SET_E_STEP_DIR(1);
-      #if E_STEPPERS > 2
-        SET_E_STEP_DIR(2);
-        #if E_STEPPERS > 3
-          SET_E_STEP_DIR(3);
-          #if E_STEPPERS > 4
-            SET_E_STEP_DIR(4);
-          #endif
-        #endif
-      #endif
-    #endif
+    if (!shaping_echoes) return;
 
-    // Step all E steppers that have steps
-    for (uint8_t i = step_loops; i--;) {
+    const uint16_t now = shaping_now(shaping_ticks);
+    const uint8_t next = SHAPING_NEXT(shaping_head);
+    const bool full = next == shaping_echo[shaping_echoes - 1].index;
 
-      #if EXTRA_CYCLES_E > 20
-        uint32_t pulse_start = TCNT0;
-      #endif
+    // Merge into the newest event if no echo has been taken from it yet
+    if (shaping_echo[0].index != shaping_head) {
+      shaping_event_t &last = shaping_queue[SHAPING_PREV(shaping_head)];
+      const int16_t mx = last.steps[X_AXIS] + x, my = last.steps[Y_AXIS] + y;
+      if ((full || (uint16_t)(now - last.time) < shaping_window) && WITHIN(mx, -127, 127) && WITHIN(my, -127, 127)) {
+        last.steps[X_AXIS] = mx;
+        last.steps[Y_AXIS] = my;
+        return;
+      }
+    }
 
-      START_E_PULSE(0);
-      #if E_STEPPERS > 1
-        START_E_PULSE(1);
-        #if E_STEPPERS > 2
-          START_E_PULSE(2);
-          #if E_STEPPERS > 3
-            START_E_PULSE(3);
-            #if E_STEPPERS > 4
-              START_E_PULSE(4);
-            #endif
-          #endif
-        #endif
-      #endif
+    // No room to delay these steps, so take all the impulses now
+    if (full) {
+      for (uint8_t e = 0; e < shaping_echoes; e++) {
+        const shaping_echo_t &echo = shaping_echo[e];
+        shaping_move(echo.axis, (echo.axis == X_AXIS ? x : y) * echo.gain);
+      }
+      return;
+    }
 
-      // For minimum pulse time wait before stopping pulses
-      #if EXTRA_CYCLES_E > 20
-        while (EXTRA_CYCLES_E > (uint32_t)(TCNT0 - pulse_start) * (INT0_PRESCALER)) { /* nada */ }
-        pulse_start = TCNT0;
-      #elif EXTRA_CYCLES_E > 0
-        DELAY_NOPS(EXTRA_CYCLES_E);
-      #endif
+    shaping_event_t &event = shaping_queue[shaping_head];
+    event.time = now;
+    event.steps[X_AXIS] = x;
+    event.steps[Y_AXIS] = y;
+    shaping_head = next;
+  }
 
-      STOP_E_PULSE(0);
-      #if E_STEPPERS > 1
-        STOP_E_PULSE(1);
-        #if E_STEPPERS > 2
-          STOP_E_PULSE(2);
-          #if E_STEPPERS > 3
-            STOP_E_PULSE(3);
-            #if E_STEPPERS > 4
-              STOP_E_PULSE(4);
-            #endif
-          #endif
-        #endif
-      #endif
+  /**
+   * Turn the echoes off for homing and probing moves, or back on.
+   * The echoes of earlier moves are taken before any steps go through whole.
+   */
+  void Stepper::suspend_shaping(const bool onoff) {
+    if (onoff) synchronize();
+    shaping_suspended = onoff;
+  }
 
-      // For minimum pulse time wait before looping
-      #if EXTRA_CYCLES_E > 20
-        if (i) while (EXTRA_CYCLES_E > (uint32_t)(TCNT0 - pulse_start) * (INT0_PRESCALER)) { /* nada */ }
-      #elif EXTRA_CYCLES_E > 0
-        if (i) DELAY_NOPS(EXTRA_CYCLES_E);
-      #endif
+  /**
+   * Take the echoes that are due. Return the ticks until the next one.
+   */
+  uint16_t Stepper::shaping_isr() {
+    const uint16_t now = shaping_now(shaping_ticks);
+    uint16_t next_isr = SHAPING_NEVER;
+
+    for (uint8_t e = 0; e < shaping_echoes; e++) {
+      shaping_echo_t &echo = shaping_echo[e];
+      while (echo.index != shaping_head) {
+        const shaping_event_t &event = shaping_queue[echo.index];
+        const uint16_t age = now - event.time;
+        if (age < echo.delay) {
+          // Wake up when the clock reaches the delay
+          const uint16_t wait = echo.delay - age;
+          if (wait < SHAPING_NEVER >> 4) NOMORE(next_isr, (wait << 4) - ((uint8_t)shaping_ticks & 0x0F));
+          break;
+        }
+        shaping_move(echo.axis, event.steps[echo.axis] * echo.gain);
+        echo.index = SHAPING_NEXT(echo.index);
+      }
+    }
 
-    } // steps_loop
+    return next_isr;
   }
 
-  void Stepper::advance_isr_scheduler() {
+  void Stepper::shaping_isr_scheduler() {
     // Disable Timer0 ISRs and enable global ISR again to capture UART events (incoming chars)
     CBI(TIMSK0, OCIE0B); // Temperature ISR
     DISABLE_STEPPER_DRIVER_INTERRUPT();
     sei();
 
+    // Timer1 restarted at the compare match, so OCR1A ticks have passed
+    shaping_ticks += OCR1A;
+
     // Run main stepping ISR if flagged
-    if (!nextMainISR) isr();
-
-    // Run Advance stepping ISR if flagged
-    if (!nextAdvanceISR) advance_isr();
-
-    // Is the next advance ISR scheduled before the next main ISR?
-    if (nextAdvanceISR <= nextMainISR) {
-      // Set up the next interrupt
-      OCR1A = nextAdvanceISR;
-      // New interval for the next main ISR
-      if (nextMainISR) nextMainISR -= nextAdvanceISR;
-      // Will call Stepper::advance_isr on the next interrupt
-      nextAdvanceISR = 0;
+    if (!nextMainISR) {
+      #if ENABLED(ISR_PROFILING)
+        const uint16_t isr_start = TCNT1;
+        isr();
+        isr_profiler.record(isr_profiler.stepper_isr, TCNT1 - isr_start);
+      #else
+        isr();
+      #endif
+    }
+
+    // Take due echoes, including those of steps just taken
+    const uint16_t nextShapingISR = shaping_isr();
+
+    // Is the next echo due before the next main ISR?
+    if (nextShapingISR < nextMainISR) {
+      OCR1A = nextShapingISR;
+      nextMainISR -= nextShapingISR;
     }
     else {
-      // The next main ISR comes first
       OCR1A = nextMainISR;
-      // New interval for the next advance ISR, if any
-      if (nextAdvanceISR && nextAdvanceISR != ADV_NEVER)
-        nextAdvanceISR -= nextMainISR;
-      // Will call Stepper::isr on the next interrupt
       nextMainISR = 0;
     }
 
     // Don't run the ISR faster than possible
-    NOLESS(OCR1A, TCNT1 + 16);
+    LIMIT_OCR1A();
 
     // Restore original ISR settings
     _ENABLE_ISRs();
   }
 
-#endif // LIN_ADVANCE
+  /**
+   * Convert the frequency, damping, and type of each axis into impulse
+   * gains and delays for the ISR. Also called by settings.postprocess().
+   *
+   *   ZV  : 1, K      at 0, T/2        K = e^(-zeta*PI/sqrt(1-zeta^2))
+   *   ZVD : 1, 2K, K² at 0, T/2, T     T = 1 / damped frequency
+   *   MZV : 1-sqrt(1/2), (sqrt(2)-1)K, (1-sqrt(1/2))K² at 0, 3T/8, 3T/4 with K^(3/4)
+   */
+  void Stepper::refresh_shaping() {
+    synchronize();
+
+    shaping_echo_t echo[4];
+    uint8_t echoes = 0;
+    uint16_t gain[2], longest = 0;
+
+    LOOP_S_LE_N(axis, X_AXIS, Y_AXIS) {
+      const float f = shaping_frequency[axis];
+      gain[axis] = 256;
+      if (f <= 0) continue;
+
+      const float zeta = shaping_zeta[axis], root = SQRT(1 - sq(zeta));
+      float a1, a2, a3, delay;
+      if (shaping_type[axis] == SHAPER_MZV) {
+        const float K = exp(-0.75f * zeta * M_PI / root);
+        a1 = 1 - M_SQRT1_2;
+        a2 = (M_SQRT2 - 1) * K;
+        a3 = a1 * sq(K);
+        delay = 0.375f;
+      }
+      else {
+        const float K = exp(-zeta * M_PI / root);
+        a1 = 1;
+        a2 = shaping_type[axis] == SHAPER_ZVD ? 2 * K : K;
+        a3 = shaping_type[axis] == SHAPER_ZVD ? sq(K) : 0;
+        delay = 0.5f;
+      }
+
+      // Gains in 1/256 step that always add up to a full step
+      const float scale = 256 / (a1 + a2 + a3);
+      const uint8_t g2 = LROUND(a2 * scale), g3 = LROUND(a3 * scale);
+      gain[axis] = 256 - g2 - g3;
+
+      // Delay in units of 16 timer ticks
+      const uint16_t d = LROUND(delay * (F_CPU / 128) / (f * root));
+      echo[echoes++] = { d, g2, 0, (AxisEnum)axis };
+      if (g3) echo[echoes++] = { (uint16_t)(d * 2), g3, 0, (AxisEnum)axis };
+      NOLESS(longest, g3 ? d * 2 : d);
+    }
+
+    // Sort by delay so the first echo is the soonest and the last frees the queue
+    for (uint8_t i = 1; i < echoes; i++)
+      for (uint8_t j = i; j && echo[j].delay < echo[j - 1].delay; j--) {
+        const shaping_echo_t tmp = echo[j];
+        echo[j] = echo[j - 1];
+        echo[j - 1] = tmp;
+      }
+
+    CRITICAL_SECTION_START;
+      for (uint8_t e = 0; e < echoes; e++) {
+        shaping_echo[e] = echo[e];
+        shaping_echo[e].index = shaping_head;
+      }
+      shaping_echoes = echoes;
+      shaping_gain[X_AXIS] = gain[X_AXIS];
+      shaping_gain[Y_AXIS] = gain[Y_AXIS];
+      // Spread the events over the queue for the longest delay
+      shaping_window = max(1, longest / (SHAPING_BUFFER_SIZE - 2));
+    CRITICAL_SECTION_END;
+  }
+
+#endif // INPUT_SHAPING
 
 void Stepper::init() {
 
@@ -1125,11 +1295,6 @@ void Stepper::init() {
   TCNT1 = 0;
   ENABLE_STEPPER_DRIVER_INTERRUPT();
 
-  #if ENABLED(LIN_ADVANCE)
-    for (uint8_t i = 0; i < COUNT(e_steps); i++) e_steps[i] = 0;
-    ZERO(current_adv_steps);
-  #endif
-
   endstops.enable(true); // Start with endstops active. After homing they can be disabled
   sei();
 
@@ -1140,7 +1305,21 @@ void Stepper::init() {
 /**
  * Block until all buffered steps are executed / cleaned
  */
-void Stepper::synchronize() { while (planner.blocks_queued() || cleaning_buffer_counter) idle(); }
+void Stepper::synchronize() {
+  #if ENABLED(ISR_PROFILING)
+    isr_profiler.synchronizing = true;
+  #endif
+
+  while (planner.blocks_queued() || cleaning_buffer_counter
+    #if ENABLED(INPUT_SHAPING)
+      || shaping_busy()
+    #endif
+  ) idle();
+
+  #if ENABLED(ISR_PROFILING)
+    isr_profiler.synchronizing = false;
+  #endif
+}
 
 /**
  * Set the stepper positions directly in steps
@@ -1242,31 +1421,47 @@ void Stepper::quick_stop() {
   DISABLE_STEPPER_DRIVER_INTERRUPT();
   while (planner.blocks_queued()) planner.discard_current_block();
   current_block = NULL;
+  #if ENABLED(LIN_ADVANCE)
+    discard_la_steps();
+  #endif
   ENABLE_STEPPER_DRIVER_INTERRUPT();
-  #if ENABLED(ULTRA_LCD)
+  #if ENABLED(MOVE_COALESCING)
+    planner.discard_coalesced_line();
+  #endif
+  #if HAS_BLOCK_BUFFER_RUNTIME
     planner.clear_block_buffer_runtime();
   #endif
 }
 
 void Stepper::endstop_triggered(AxisEnum axis) {
 
-  #if IS_CORE
-
-    endstops_trigsteps[axis] = 0.5f * (
-      axis == CORE_AXIS_2 ? CORESIGN(count_position[CORE_AXIS_1] - count_position[CORE_AXIS_2])
-                          : count_position[CORE_AXIS_1] + count_position[CORE_AXIS_2]
-    );
-
-  #else // !COREXY && !COREXZ && !COREYZ
-
-    endstops_trigsteps[axis] = count_position[axis];
+  #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+    /**
+     * Use the position taken when the pin changed. The debounce only confirms it
+     * a few steps later. If the pin interrupt caught the stepper ISR part way
+     * through updating count_position the copy is off by 255 steps or more.
+     */
+    bool use_edge = edge_captured;
+    LOOP_XYZ(i) if (labs(edge_position[i] - count_position[i]) > 127) use_edge = false;
+    const volatile long * const trig_position = use_edge ? edge_position : count_position;
+    release_endstop_edge();
+  #else
+    const volatile long * const trig_position = count_position;
+  #endif
 
-  #endif // !COREXY && !COREXZ && !COREYZ
+  endstops_trigsteps[axis] = axis_steps(trig_position, axis);
 
   kill_current_block();
   cleaning_buffer_counter = -1; // Discard the rest of the move
 }
 
+float Stepper::triggered_overshoot_mm(const AxisEnum axis) {
+  CRITICAL_SECTION_START;
+  const long pos = axis_steps(count_position, axis);
+  CRITICAL_SECTION_END;
+  return (pos - endstops_trigsteps[axis]) * planner.steps_to_mm[axis];
+}
+
 void Stepper::report_positions() {
   CRITICAL_SECTION_START;
   const long xpos = count_position[X_AXIS],
@@ -1300,110 +1495,84 @@ void Stepper::report_positions() {
 
 #if ENABLED(BABYSTEPPING)
 
-  #if ENABLED(DELTA)
-    #define CYCLES_EATEN_BABYSTEP (2 * 15)
-  #else
-    #define CYCLES_EATEN_BABYSTEP 0
-  #endif
-  #define EXTRA_CYCLES_BABYSTEP (STEP_PULSE_CYCLES - (CYCLES_EATEN_BABYSTEP))
-
   #define _ENABLE(AXIS) enable_## AXIS()
   #define _READ_DIR(AXIS) AXIS ##_DIR_READ
   #define _INVERT_DIR(AXIS) INVERT_## AXIS ##_DIR
   #define _APPLY_DIR(AXIS, INVERT) AXIS ##_APPLY_DIR(INVERT, true)
+  #define _APPLY_STEP(AXIS) AXIS ##_APPLY_STEP
+  #define _INVERT_STEP_PIN(AXIS) INVERT_## AXIS ##_STEP_PIN
 
-  #if EXTRA_CYCLES_BABYSTEP > 20
-    #define _SAVE_START const uint32_t pulse_start = TCNT0
-    #define _PULSE_WAIT while (EXTRA_CYCLES_BABYSTEP > (uint32_t)(TCNT0 - pulse_start) * (INT0_PRESCALER)) { /* nada */ }
-  #else
-    #define _SAVE_START NOOP
-    #if EXTRA_CYCLES_BABYSTEP > 0
-      #define _PULSE_WAIT DELAY_NOPS(EXTRA_CYCLES_BABYSTEP)
-    #elif STEP_PULSE_CYCLES > 0
-      #define _PULSE_WAIT NOOP
-    #elif ENABLED(DELTA)
-      #define _PULSE_WAIT delayMicroseconds(2);
-    #else
-      #define _PULSE_WAIT delayMicroseconds(4);
-    #endif
-  #endif
-
-  #define BABYSTEP_AXIS(AXIS, INVERT) {                     \
-      const uint8_t old_dir = _READ_DIR(AXIS);              \
+  // Save the direction of an axis, set the babystep direction, and start the pulse
+  #define BABYSTEP_START(AXIS, INVERT) do{                   \
       _ENABLE(AXIS);                                        \
-      _SAVE_START;                                          \
+      SET_BIT(babystep_dirs, _AXIS(AXIS), _READ_DIR(AXIS)); \
       _APPLY_DIR(AXIS, _INVERT_DIR(AXIS)^direction^INVERT); \
       _APPLY_STEP(AXIS)(!_INVERT_STEP_PIN(AXIS), true);     \
-      _PULSE_WAIT;                                          \
+    }while(0)
+
+  // End the pulse and put the direction back for the block
+  #define BABYSTEP_FINISH(AXIS) do{                          \
       _APPLY_STEP(AXIS)(_INVERT_STEP_PIN(AXIS), true);      \
-      _APPLY_DIR(AXIS, old_dir);                            \
-    }
+      _APPLY_DIR(AXIS, TEST(babystep_dirs, _AXIS(AXIS)));   \
+    }while(0)
 
-  // MUST ONLY BE CALLED BY AN ISR,
-  // No other ISR should ever interrupt this!
-  void Stepper::babystep(const AxisEnum axis, const bool direction) {
-    cli();
+  /**
+   * Babysteps are a channel of the stepper ISR. babystep_start() runs after the
+   * block's pulses are done and raises the STEP pins. babystep_finish() drops them
+   * as the next interrupt comes in, before anything else is stepped. The time
+   * between interrupts is the pulse width, so there's no busy-wait, and the pulse
+   * never overlaps a block step on the same motor.
+   *
+   * Called with the time since the last interrupt, for the rate limit.
+   */
+  void Stepper::babystep_start(const uint16_t elapsed) {
+    babystep_ticks = (elapsed >= BABYSTEP_TICKS - babystep_ticks) ? BABYSTEP_TICKS : babystep_ticks + elapsed;
+    if (babystep_ticks < BABYSTEP_TICKS) return;
 
-    switch (axis) {
+    LOOP_XYZ(axis) {
+      const int curTodo = thermalManager.babystepsTodo[axis]; // get rid of volatile for performance
+      if (!curTodo) continue;
+      const bool direction = curTodo > 0;
 
-      #if ENABLED(BABYSTEP_XY)
+      switch (axis) {
 
-        case X_AXIS:
-          BABYSTEP_AXIS(X, false);
-          break;
+        #if ENABLED(BABYSTEP_XY)
+          case X_AXIS: BABYSTEP_START(X, false); break;
+          case Y_AXIS: BABYSTEP_START(Y, false); break;
+        #endif
 
-        case Y_AXIS:
-          BABYSTEP_AXIS(Y, false);
+        case Z_AXIS:
+          #if ENABLED(DELTA)
+            BABYSTEP_START(X, BABYSTEP_INVERT_Z);
+            BABYSTEP_START(Y, BABYSTEP_INVERT_Z);
+          #endif
+          BABYSTEP_START(Z, BABYSTEP_INVERT_Z);
           break;
 
-      #endif
-
-      case Z_AXIS: {
-
-        #if DISABLED(DELTA)
-
-          BABYSTEP_AXIS(Z, BABYSTEP_INVERT_Z);
-
-        #else // DELTA
-
-          const bool z_direction = direction ^ BABYSTEP_INVERT_Z;
-
-          enable_X();
-          enable_Y();
-          enable_Z();
-
-          const uint8_t old_x_dir_pin = X_DIR_READ,
-                        old_y_dir_pin = Y_DIR_READ,
-                        old_z_dir_pin = Z_DIR_READ;
-
-          X_DIR_WRITE(INVERT_X_DIR ^ z_direction);
-          Y_DIR_WRITE(INVERT_Y_DIR ^ z_direction);
-          Z_DIR_WRITE(INVERT_Z_DIR ^ z_direction);
-
-          _SAVE_START;
-
-          X_STEP_WRITE(!INVERT_X_STEP_PIN);
-          Y_STEP_WRITE(!INVERT_Y_STEP_PIN);
-          Z_STEP_WRITE(!INVERT_Z_STEP_PIN);
-
-          _PULSE_WAIT;
-
-          X_STEP_WRITE(INVERT_X_STEP_PIN);
-          Y_STEP_WRITE(INVERT_Y_STEP_PIN);
-          Z_STEP_WRITE(INVERT_Z_STEP_PIN);
-
-          // Restore direction bits
-          X_DIR_WRITE(old_x_dir_pin);
-          Y_DIR_WRITE(old_y_dir_pin);
-          Z_DIR_WRITE(old_z_dir_pin);
+        default: continue;
+      }
 
-        #endif
+      SBI(babystep_axes, axis);
+      if (direction) thermalManager.babystepsTodo[axis]--;
+                else thermalManager.babystepsTodo[axis]++;
+    }
 
-      } break;
+    if (babystep_axes) babystep_ticks = 0;
+  }
 
-      default: break;
+  void Stepper::babystep_finish_pulses() {
+    #if ENABLED(BABYSTEP_XY)
+      if (TEST(babystep_axes, X_AXIS)) BABYSTEP_FINISH(X);
+      if (TEST(babystep_axes, Y_AXIS)) BABYSTEP_FINISH(Y);
+    #endif
+    if (TEST(babystep_axes, Z_AXIS)) {
+      #if ENABLED(DELTA)
+        BABYSTEP_FINISH(X);
+        BABYSTEP_FINISH(Y);
+      #endif
+      BABYSTEP_FINISH(Z);
     }
-    sei();
+    babystep_axes = 0;
   }
 
 #endif // BABYSTEPPING
@@ -55,6 +55,24 @@ extern Stepper stepper;
 #define ENABLE_STEPPER_DRIVER_INTERRUPT()  SBI(TIMSK1, OCIE1A)
 #define DISABLE_STEPPER_DRIVER_INTERRUPT() CBI(TIMSK1, OCIE1A)
 
+#if ENABLED(INPUT_SHAPING)
+
+  // X and Y steps taken by one (or a few merged) stepper ISRs
+  typedef struct {
+    uint16_t time;        // When the steps were taken, in units of 16 timer ticks
+    int8_t steps[2];      // Signed X and Y steps
+  } shaping_event_t;
+
+  // A delayed impulse of the shaper for one axis
+  typedef struct {
+    uint16_t delay;       // Time after the steps, in units of 16 timer ticks
+    uint8_t gain,         // Share of each step, in 1/256 step
+            index;        // The next event in the queue to be echoed
+    AxisEnum axis;
+  } shaping_echo_t;
+
+#endif
+
 // intRes = intIn1 * intIn2 >> 16
 // uses:
 // r26 to store 0
@@ -94,6 +112,12 @@ class Stepper {
       static bool performing_homing;
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+      static float shaping_frequency[2],           // Ringing frequency of X and Y (Hz). 0 to disable.
+                   shaping_zeta[2];                // Damping ratio of X and Y
+      static ShaperType shaping_type[2];
+    #endif
+
     #if HAS_MOTOR_CURRENT_PWM
       #ifndef PWM_MOTOR_CURRENT
         #define PWM_MOTOR_CURRENT DEFAULT_PWM_MOTOR_CURRENT
@@ -121,21 +145,37 @@ class Stepper {
     static long counter_X, counter_Y, counter_Z, counter_E;
     static volatile uint32_t step_events_completed; // The number of step events executed in the current block
 
-    #if ENABLED(LIN_ADVANCE)
+    #if HAS_STEPPER_SCHEDULER
 
-      static uint16_t nextMainISR, nextAdvanceISR, eISR_Rate;
+      static uint16_t nextMainISR;
       #define _NEXT_ISR(T) nextMainISR = T
-      static volatile int e_steps[E_STEPPERS];
-      static int final_estep_rate;
-      static int current_estep_rate[E_STEPPERS]; // Actual extruder speed [steps/s]
-      static int current_adv_steps[E_STEPPERS];  // The amount of current added esteps due to advance.
-                                                 // i.e., the current amount of pressure applied
-                                                 // to the spring (=filament).
-    #else // !LIN_ADVANCE
+
+    #else
 
       #define _NEXT_ISR(T) OCR1A = T
 
-    #endif // !LIN_ADVANCE
+    #endif
+
+    #if ENABLED(LIN_ADVANCE)
+      static int16_t la_steps;                   // E steps waiting to be taken, linear and advance
+      static int16_t current_adv_steps;          // The amount of current added esteps due to advance.
+                                                 // i.e., the current amount of pressure applied
+                                                 // to the spring (=filament).
+      static int8_t la_dir;                      // Current E DIR: 1, -1, or 0 if not yet set
+    #endif // LIN_ADVANCE
+
+    #if ENABLED(INPUT_SHAPING)
+      static uint32_t shaping_ticks;                   // Timer1 ticks elapsed, for timing the echoes
+      static uint16_t shaping_gain[2];                 // Share of each step taken right away, in 1/256 step
+      static uint16_t shaping_window;                  // Steps closer than this share one queue event
+      static int16_t shaping_frac[2];                  // Motor position error, in 1/256 step
+      static int8_t shaping_dir[2];                    // Current DIR of the shaped motors
+      static shaping_event_t shaping_queue[SHAPING_BUFFER_SIZE];
+      static uint8_t shaping_head;                     // Where the next event goes
+      static shaping_echo_t shaping_echo[4];           // Active echoes, shortest delay first
+      static uint8_t shaping_echoes;
+      static bool shaping_suspended;                   // Steps are taken whole for homing and probing
+    #endif
 
     static long acceleration_time, deceleration_time;
     static uint8_t step_loops, step_loops_nominal;
@@ -146,6 +186,18 @@ class Stepper {
     static volatile long endstops_trigsteps[XYZ];
     static volatile long endstops_stepsTotal, endstops_stepsDone;
 
+    #if ENABLED(BABYSTEPPING)
+      static uint8_t babystep_axes,                   // Axes with a babystep pulse in progress
+                     babystep_dirs;                   // Their direction pins before the babystep
+      static uint16_t babystep_ticks;                 // Timer ticks since the last babystep
+      static void babystep_finish_pulses();
+    #endif
+
+    #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+      static volatile bool edge_captured;             // edge_position holds the position at an endstop pin change
+      static long edge_position[XYZ];
+    #endif
+
     //
     // Positions of stepper motors, in step units
     //
@@ -184,9 +236,8 @@ class Stepper {
 
     static void isr();
 
-    #if ENABLED(LIN_ADVANCE)
-      static void advance_isr();
-      static void advance_isr_scheduler();
+    #if ENABLED(INPUT_SHAPING)
+      static void shaping_isr_scheduler();
     #endif
 
     //
@@ -277,7 +328,10 @@ class Stepper {
     #endif
 
     #if ENABLED(BABYSTEPPING)
-      static void babystep(const AxisEnum axis, const bool direction); // perform a short step with a single stepper motor, outside of any convention
+      static void babystep_start(const uint16_t elapsed);  // Start pulses for due babysteps, called by the stepper ISR
+      FORCE_INLINE static void babystep_finish() {         // End them, called at the next stepper interrupt
+        if (babystep_axes) babystep_finish_pulses();
+      }
     #endif
 
     static inline void kill_current_block() {
@@ -289,6 +343,30 @@ class Stepper {
     //
     static void endstop_triggered(const AxisEnum axis);
 
+    //
+    // Position of an axis in steps, from a set of motor positions
+    //
+    FORCE_INLINE static long axis_steps(const volatile long * const pos, const AxisEnum axis) {
+      #if IS_CORE
+        if (axis == CORE_AXIS_1) return 0.5f * (pos[CORE_AXIS_1] + pos[CORE_AXIS_2]);
+        if (axis == CORE_AXIS_2) return 0.5f * CORESIGN(pos[CORE_AXIS_1] - pos[CORE_AXIS_2]);
+      #endif
+      return pos[axis];
+    }
+
+    #if ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
+      //
+      // Called from the endstop pin interrupts. Keep the position of the first
+      // change until the endstops have been checked, so bounces don't move it.
+      //
+      FORCE_INLINE static void capture_endstop_edge() {
+        if (edge_captured) return;
+        LOOP_XYZ(i) edge_position[i] = count_position[i];
+        edge_captured = true;
+      }
+      FORCE_INLINE static void release_endstop_edge() { edge_captured = false; }
+    #endif
+
     //
     // Triggered position of an axis in mm (not core-savvy)
     //
@@ -296,12 +374,43 @@ class Stepper {
       return endstops_trigsteps[axis] * planner.steps_to_mm[axis];
     }
 
+    //
+    // Distance in mm an axis has moved since its endstop triggered
+    //
+    static float triggered_overshoot_mm(const AxisEnum axis);
+
     #if HAS_MOTOR_CURRENT_PWM
       static void refresh_motor_power();
     #endif
 
+    #if ENABLED(INPUT_SHAPING)
+      //
+      // Apply new shaping frequency, damping, or type. Waits for the steppers.
+      //
+      static void refresh_shaping();
+
+      //
+      // Are delayed steps still waiting to be taken?
+      //
+      FORCE_INLINE static bool shaping_busy() {
+        return shaping_echoes && shaping_echo[shaping_echoes - 1].index != shaping_head;
+      }
+
+      //
+      // Take whole X and Y steps, with no echoes, while homing or probing.
+      // The endstops then stop the carriage where count_position says it is.
+      //
+      static void suspend_shaping(const bool onoff);
+    #endif
+
   private:
 
+    #if ENABLED(INPUT_SHAPING)
+      static void shaping_move(const AxisEnum axis, const int16_t amount);
+      static void shaping_enqueue(const int8_t x, const int8_t y);
+      static uint16_t shaping_isr();
+    #endif
+
     FORCE_INLINE static unsigned short calc_timer_interval(unsigned short step_rate) {
       unsigned short timer;
 
@@ -342,6 +451,22 @@ class Stepper {
       return timer;
     }
 
+    #if ENABLED(LIN_ADVANCE)
+      // Add or remove steps to reach the advance for the current step rate
+      FORCE_INLINE static void advance_to(const int16_t adv_steps) {
+        la_steps += adv_steps - current_adv_steps;
+        current_adv_steps = adv_steps;
+      }
+
+      // Drop the pending E steps. The linear ones are already in count_position
+      // but never reach the motor, so take them back off.
+      FORCE_INLINE static void discard_la_steps() {
+        count_position[E_AXIS] -= la_steps - current_adv_steps;
+        la_steps = current_adv_steps = 0;
+        la_dir = 0;
+      }
+    #endif
+
     // Initialize the trapezoid generator from the current block.
     // Called whenever a new block begins.
     FORCE_INLINE static void trapezoid_generator_reset() {
@@ -349,6 +474,12 @@ class Stepper {
       static int8_t last_extruder = -1;
 
       if (current_block->direction_bits != last_direction_bits || current_block->active_extruder != last_extruder) {
+        #if ENABLED(LIN_ADVANCE)
+          if (current_block->active_extruder != last_extruder) {
+            // Pending steps belong to the last extruder. Start the new one from rest.
+            discard_la_steps();
+          }
+        #endif
         last_direction_bits = current_block->direction_bits;
         last_extruder = current_block->active_extruder;
         set_directions();
@@ -364,10 +495,8 @@ class Stepper {
       _NEXT_ISR(acceleration_time);
 
       #if ENABLED(LIN_ADVANCE)
-        if (current_block->use_advance_lead) {
-          current_estep_rate[current_block->active_extruder] = ((unsigned long)acc_step_rate * current_block->abs_adv_steps_multiplier8) >> 17;
-          final_estep_rate = (current_block->nominal_rate * current_block->abs_adv_steps_multiplier8) >> 17;
-        }
+        if (current_block->use_advance_lead)
+          advance_to(((uint32_t)acc_step_rate * current_block->abs_adv_steps_multiplier8) >> 17);
       #endif
 
       // SERIAL_ECHO_START();
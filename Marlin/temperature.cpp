@@ -35,7 +35,7 @@
   #include "MarlinSPI.h"
 #endif
 
-#if ENABLED(BABYSTEPPING)
+#if ENABLED(BABYSTEPPING) || ENABLED(ENDSTOP_INTERRUPTS_FEATURE)
   #include "stepper.h"
 #endif
 
@@ -47,6 +47,10 @@
   #include "watchdog.h"
 #endif
 
+#if ENABLED(ISR_PROFILING)
+  #include "isr_profiler.h"
+#endif
+
 #if ENABLED(TEMP_SENSOR_1_AS_REDUNDANT)
   static void* heater_ttbl_map[2] = { (void*)HEATER_0_TEMPTABLE, (void*)HEATER_1_TEMPTABLE };
   static uint8_t heater_ttbllen_map[2] = { HEATER_0_TEMPTABLE_LEN, HEATER_1_TEMPTABLE_LEN };
@@ -1640,7 +1644,6 @@ void Temperature::set_current_temp_raw() {
  *  - Manage PWM to all the heaters and fan
  *  - Prepare or Measure one of the raw ADC sensor values
  *  - Check new temperature values for MIN/MAX errors (kill on error)
- *  - Step the babysteps value for each axis towards 0
  *  - For PINS_DEBUGGING, monitor and report endstop pins
  *  - For ENDSTOP_INTERRUPTS_FEATURE check endstops if flagged
  */
@@ -1654,6 +1657,10 @@ void Temperature::isr() {
   if (in_temp_isr) return;
   in_temp_isr = true;
 
+  #if ENABLED(ISR_PROFILING)
+    const uint8_t isr_start = TCNT0; // Includes any stepper ISR that interrupts this one
+  #endif
+
   // Allow UART and stepper ISRs
   CBI(TIMSK0, OCIE0B); //Disable Temperature ISR
   sei();
@@ -2147,17 +2154,6 @@ void Temperature::isr() {
   adc_sensor_state = (ADCSensorState)(int(adc_sensor_state) + 1);
   if (adc_sensor_state > SensorsReady) adc_sensor_state = (ADCSensorState)0;
 
-  #if ENABLED(BABYSTEPPING)
-    LOOP_XYZ(axis) {
-      const int curTodo = babystepsTodo[axis]; // get rid of volatile for performance
-      if (curTodo) {
-        stepper.babystep((AxisEnum)axis, curTodo > 0);
-        if (curTodo > 0) babystepsTodo[axis]--;
-                    else babystepsTodo[axis]++;
-      }
-    }
-  #endif // BABYSTEPPING
-
   #if ENABLED(PINS_DEBUGGING)
     extern bool endstop_monitor_flag;
     // run the endstop monitor at 15Hz
@@ -2173,13 +2169,22 @@ void Temperature::isr() {
 
     extern volatile uint8_t e_hit;
 
+    // Fallback poll in case a pin change was missed (~64ms)
+    static uint8_t endstop_poll_count = 0;
+    if (!(++endstop_poll_count & 0x3F) && !e_hit) e_hit = 2;
+
     if (e_hit && ENDSTOPS_ENABLED) {
       endstops.update();  // call endstop update routine
-      e_hit--;
+      if (!--e_hit) stepper.release_endstop_edge();
     }
   #endif
 
   cli();
+
+  #if ENABLED(ISR_PROFILING)
+    isr_profiler.record(isr_profiler.temp_isr, (uint8_t)(TCNT0 - isr_start));
+  #endif
+
   in_temp_isr = false;
   SBI(TIMSK0, OCIE0B); //re-enable Temperature ISR
 }
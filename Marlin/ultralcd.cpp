@@ -139,6 +139,30 @@ uint16_t max_display_update_time = 0;
 
 #if ENABLED(DOGLCD)
   bool drawing_screen = false;
+
+  #if ENABLED(LCD_PLANNER_BUDGET)
+
+    // Recent cost of drawing one display page. Start from a conservative guess,
+    // above what a full page costs on a 16MHz board, until one is measured.
+    uint16_t lcd_page_us = 8000;
+    millis_t lcd_last_page_ms = 0;  // When the last page was drawn
+
+    /**
+     * Time that may be spent drawing pages in this call.
+     *
+     * Half of the motion queued beyond LCD_BUDGET_RESERVE_MS may be used, up
+     * to LCD_BUDGET_MAX_US. Nothing may be used close to starvation, except
+     * for one page a second so the display doesn't freeze on a slow host.
+     */
+    static uint32_t lcd_draw_budget_us(const millis_t &ms) {
+      if (!planner.blocks_queued()) return LCD_BUDGET_MAX_US;
+      const uint16_t queued_ms = planner.block_buffer_runtime();
+      if (queued_ms > (LCD_BUDGET_RESERVE_MS))
+        return min(uint32_t(queued_ms - (LCD_BUDGET_RESERVE_MS)) * 500UL, uint32_t(LCD_BUDGET_MAX_US));
+      return ELAPSED(ms, lcd_last_page_ms + 1000UL) ? lcd_page_us : 0;
+    }
+
+  #endif
 #endif
 
 #if ENABLED(DAC_STEPPER_CURRENT)
@@ -651,6 +675,7 @@ void lcd_status_screen() {
         if (progress_bar_percent > 2 && !print_job_timer.isPaused()) {
           if (ELAPSED(ms, expire_status_ms)) {
             lcd_status_message[0] = '\0';
+            lcd_status_changed();
             expire_status_ms = 0;
           }
         }
@@ -4752,8 +4777,14 @@ void lcd_update() {
       }
     #endif
 
-    // then we want to use 1/2 of the time only.
-    uint16_t bbr2 = planner.block_buffer_runtime() >> 1;
+    #if ENABLED(LCD_PLANNER_BUDGET)
+      uint32_t draw_budget_us = lcd_draw_budget_us(ms);
+      #define CAN_DRAW (draw_budget_us && draw_budget_us >= lcd_page_us)
+    #else
+      // then we want to use 1/2 of the time only.
+      uint16_t bbr2 = planner.block_buffer_runtime() >> 1;
+      #define CAN_DRAW (!bbr2 || bbr2 > max_display_update_time)
+    #endif
 
     #if ENABLED(DOGLCD)
       #define IS_DRAWING drawing_screen
@@ -4761,7 +4792,7 @@ void lcd_update() {
       #define IS_DRAWING false
     #endif
 
-    if ((lcdDrawUpdate || IS_DRAWING) && (!bbr2 || bbr2 > max_display_update_time)) {
+    if ((lcdDrawUpdate || IS_DRAWING) && CAN_DRAW) {
 
       if (!IS_DRAWING) switch (lcdDrawUpdate) {
         case LCDVIEW_CALL_NO_REDRAW:
@@ -4790,17 +4821,39 @@ void lcd_update() {
           u8g.firstPage();                            // Start the first page
           drawing_screen = 1;                         // Flag as drawing pages
         }
-        lcd_setFont(FONT_MENU);                       // Setup font for every page draw
-        u8g.setColorIndex(1);                         // And reset the color
-        CURRENTSCREEN();                              // Draw and process the current screen
-
-        // The screen handler can clear drawing_screen for an action that changes the screen.
-        // If still drawing and there's another page, update max-time and return now.
-        // The nextPage will already be set up on the next call.
-        if (drawing_screen && (drawing_screen = u8g.nextPage())) {
-          NOLESS(max_display_update_time, millis() - ms);
-          return;
-        }
+        #if ENABLED(LCD_PLANNER_BUDGET)
+          // Draw as many pages as the budget allows, then resume on a later call
+          for (;;) {
+            const uint32_t page_start_us = micros();
+            lcd_setFont(FONT_MENU);
+            u8g.setColorIndex(1);
+            CURRENTSCREEN();
+            if (drawing_screen) drawing_screen = u8g.nextPage();
+
+            // Track the page cost, rising at once and falling slowly.
+            // The first measurement replaces the initial guess.
+            const uint32_t page_us = micros() - page_start_us;
+            if (page_us >= lcd_page_us || !lcd_last_page_ms) lcd_page_us = min(page_us, 0xFFFFUL);
+            else lcd_page_us -= (lcd_page_us - page_us) >> 3;
+            lcd_last_page_ms = millis();
+
+            if (!drawing_screen) break;
+            draw_budget_us = draw_budget_us > page_us ? draw_budget_us - page_us : 0;
+            if (draw_budget_us < lcd_page_us) return;
+          }
+        #else
+          lcd_setFont(FONT_MENU);                       // Setup font for every page draw
+          u8g.setColorIndex(1);                         // And reset the color
+          CURRENTSCREEN();                              // Draw and process the current screen
+
+          // The screen handler can clear drawing_screen for an action that changes the screen.
+          // If still drawing and there's another page, update max-time and return now.
+          // The nextPage will already be set up on the next call.
+          if (drawing_screen && (drawing_screen = u8g.nextPage())) {
+            NOLESS(max_display_update_time, millis() - ms);
+            return;
+          }
+        #endif
       #else
         CURRENTSCREEN();
       #endif
@@ -4858,6 +4911,7 @@ inline void pad_message_string() {
 void lcd_finishstatus(const bool persist=false) {
 
   pad_message_string();
+  lcd_status_changed();
 
   #if !(ENABLED(LCD_PROGRESS_BAR) && (PROGRESS_MSG_EXPIRE > 0))
     UNUSED(persist);
@@ -379,10 +379,32 @@ void lcd_implementation_clear() { } // Automatically cleared by Picture Loop
 // Status Screen
 //
 
-FORCE_INLINE void _draw_centered_temp(const int16_t temp, const uint8_t x, const uint8_t y) {
-  const uint8_t degsize = 6 * (temp >= 100 ? 3 : temp >= 10 ? 2 : 1); // number's pixel width
+//
+// Text for the numbers on the Status Screen is made at the first page of a
+// frame, and only when the number has changed. The other pages just draw it.
+//
+typedef struct {
+  int16_t value;  // The number shown
+  char text[4];   // itostr3 of the number
+} status_number_t;
+
+static status_number_t status_target_temp[HOTENDS + 1], // Hotends then bed
+                       status_current_temp[HOTENDS + 1],
+                       status_feedrate;
+#if HAS_FAN0
+  static status_number_t status_fan;
+#endif
+
+static void update_status_number(status_number_t &n, const int16_t value) {
+  if (n.value == value && n.text[0]) return;
+  n.value = value;
+  strcpy(n.text, itostr3(value));
+}
+
+FORCE_INLINE void _draw_centered_temp(const status_number_t &temp, const uint8_t x, const uint8_t y) {
+  const uint8_t degsize = 6 * (temp.value >= 100 ? 3 : temp.value >= 10 ? 2 : 1); // number's pixel width
   u8g.setPrintPos(x - (18 - degsize) / 2, y); // move left if shorter
-  lcd_print(itostr3(temp));
+  lcd_print(temp.text);
   lcd_printPGM(PSTR(LCD_STR_DEGREE " "));
 }
 
@@ -397,6 +419,8 @@ FORCE_INLINE void _draw_heater_status(const uint8_t x, const int8_t heater, cons
     constexpr bool isBed = false;
   #endif
 
+  const uint8_t n = isBed ? HOTENDS : heater;
+
   if (PAGE_UNDER(7)) {
     #if HEATER_IDLE_HANDLER
       const bool is_idle = (!isBed ? thermalManager.is_heater_idle(heater) :
@@ -409,10 +433,10 @@ FORCE_INLINE void _draw_heater_status(const uint8_t x, const int8_t heater, cons
 
       if (blink || !is_idle)
     #endif
-    _draw_centered_temp((isBed ? thermalManager.degTargetBed() : thermalManager.degTargetHotend(heater)) + 0.5, x, 7); }
+    _draw_centered_temp(status_target_temp[n], x, 7); }
 
   if (PAGE_CONTAINS(21, 28))
-    _draw_centered_temp((isBed ? thermalManager.degBed() : thermalManager.degHotend(heater)) + 0.5, x, 28);
+    _draw_centered_temp(status_current_temp[n], x, 28);
 
   if (PAGE_CONTAINS(17, 20)) {
     const uint8_t h = isBed ? 7 : 8,
@@ -446,7 +470,9 @@ FORCE_INLINE void _draw_axis_label(const AxisEnum axis, const char* const pstr,
 }
 
 inline void lcd_implementation_status_message(const bool blink) {
-  #if ENABLED(STATUS_MESSAGE_SCROLLING)
+  #ifndef MAPPER_NON
+    lcd_print_status_glyphs(blink);
+  #elif ENABLED(STATUS_MESSAGE_SCROLLING)
     static bool last_blink = false;
     const uint8_t slen = lcd_strlen(lcd_status_message);
     const char *stat = lcd_status_message + status_scroll_pos;
@@ -487,6 +513,22 @@ static void lcd_implementation_status_screen() {
 
   const bool blink = lcd_blink();
 
+  // At the first page, update the text of any numbers that changed
+  if (page.page == 0) {
+    HOTEND_LOOP() {
+      update_status_number(status_target_temp[e], thermalManager.degTargetHotend(e) + 0.5);
+      update_status_number(status_current_temp[e], thermalManager.degHotend(e) + 0.5);
+    }
+    #if HAS_TEMP_BED
+      update_status_number(status_target_temp[HOTENDS], thermalManager.degTargetBed() + 0.5);
+      update_status_number(status_current_temp[HOTENDS], thermalManager.degBed() + 0.5);
+    #endif
+    #if HAS_FAN0
+      update_status_number(status_fan, ((fanSpeeds[0] + 1) * 100) / 256);
+    #endif
+    update_status_number(status_feedrate, feedrate_percentage);
+  }
+
   // Status Menu Font
   lcd_setFont(FONT_STATUSMENU);
 
@@ -522,10 +564,9 @@ static void lcd_implementation_status_screen() {
     #if HAS_FAN0
       if (PAGE_CONTAINS(20, 27)) {
         // Fan
-        const int16_t per = ((fanSpeeds[0] + 1) * 100) / 256;
-        if (per) {
+        if (status_fan.value) {
           u8g.setPrintPos(104, 27);
-          lcd_print(itostr3(per));
+          lcd_print(status_fan.text);
           u8g.print('%');
         }
       }
@@ -602,14 +643,21 @@ static void lcd_implementation_status_screen() {
       #define SD_DURATION_X (LCD_PIXEL_WIDTH - len * DOG_CHAR_WIDTH)
     #endif
 
-    if (PAGE_CONTAINS(41, 48)) {
-
-      char buffer[10];
+    // Only make new text when the elapsed time changes
+    static char elapsed_text[10];
+    static uint8_t len;
+    static uint32_t elapsed_shown;
+    if (page.page == 0) {
       duration_t elapsed = print_job_timer.duration();
-      bool has_days = (elapsed.value > 60*60*24L);
-      uint8_t len = elapsed.toDigital(buffer, has_days);
+      if (!len || elapsed.value != elapsed_shown) {
+        elapsed_shown = elapsed.value;
+        len = elapsed.toDigital(elapsed_text, elapsed.value > 60*60*24L);
+      }
+    }
+
+    if (PAGE_CONTAINS(41, 48)) {
       u8g.setPrintPos(SD_DURATION_X, 48);
-      lcd_print(buffer);
+      lcd_print(elapsed_text);
     }
 
   #endif
@@ -647,11 +695,15 @@ static void lcd_implementation_status_screen() {
     static char wstring[5], mstring[4];
   #endif
 
-  // At the first page, regenerate the XYZ strings
+  // At the first page, regenerate any XYZ strings that changed
   if (page.page == 0) {
-    strcpy(xstring, ftostr4sign(LOGICAL_X_POSITION(current_position[X_AXIS])));
-    strcpy(ystring, ftostr4sign(LOGICAL_Y_POSITION(current_position[Y_AXIS])));
-    strcpy(zstring, ftostr52sp(FIXFLOAT(LOGICAL_Z_POSITION(current_position[Z_AXIS]))));
+    static float xyz_shown[XYZ];
+    const float lx = LOGICAL_X_POSITION(current_position[X_AXIS]),
+                ly = LOGICAL_Y_POSITION(current_position[Y_AXIS]),
+                lz = LOGICAL_Z_POSITION(current_position[Z_AXIS]);
+    if (!xstring[0] || lx != xyz_shown[X_AXIS]) strcpy(xstring, ftostr4sign(xyz_shown[X_AXIS] = lx));
+    if (!ystring[0] || ly != xyz_shown[Y_AXIS]) strcpy(ystring, ftostr4sign(xyz_shown[Y_AXIS] = ly));
+    if (!zstring[0] || lz != xyz_shown[Z_AXIS]) strcpy(zstring, ftostr52sp(FIXFLOAT(xyz_shown[Z_AXIS] = lz)));
     #if ENABLED(FILAMENT_LCD_DISPLAY)
       strcpy(wstring, ftostr12ns(filament_width_meas));
       strcpy(mstring, itostr3(100.0 * (
@@ -709,7 +761,7 @@ static void lcd_implementation_status_screen() {
 
     lcd_setFont(FONT_STATUSMENU);
     u8g.setPrintPos(12, 50);
-    lcd_print(itostr3(feedrate_percentage));
+    lcd_print(status_feedrate.text);
     u8g.print('%');
 
     //
@@ -893,7 +893,9 @@ static void lcd_implementation_status_screen() {
 
   #endif // FILAMENT_LCD_DISPLAY && SDSUPPORT
 
-  #if ENABLED(STATUS_MESSAGE_SCROLLING)
+  #ifndef MAPPER_NON
+    lcd_print_status_glyphs(blink);
+  #elif ENABLED(STATUS_MESSAGE_SCROLLING)
     static bool last_blink = false;
     const uint8_t slen = lcd_strlen(lcd_status_message);
     const char *stat = lcd_status_message + status_scroll_pos;
@@ -108,6 +108,17 @@ static void ST7920_SWSPI_SND_8BIT(uint8_t val) {
 #define ST7920_WRITE_BYTE(a)     { ST7920_SWSPI_SND_8BIT((uint8_t)((a)&0xF0u)); ST7920_SWSPI_SND_8BIT((uint8_t)((a)<<4u)); U8G_DELAY(); }
 #define ST7920_WRITE_BYTES(p,l)  { for (uint8_t i = l + 1; --i;) { ST7920_SWSPI_SND_8BIT(*p&0xF0); ST7920_SWSPI_SND_8BIT(*p<<4); p++; } U8G_DELAY(); }
 
+#if ENABLED(ST7920_SEND_CHANGED_ROWS)
+  #include <util/crc16.h>
+
+  // Send every row now and then, in case a checksum failed to catch a change
+  #define ST7920_FULL_REFRESH_FRAMES 100
+
+  static uint16_t st7920_row_crc[LCD_PIXEL_HEIGHT]; // Checksum of each row as last sent
+  static uint8_t st7920_refresh_count = 0;         // Frames until the next full refresh
+  static bool st7920_send_all;                      // Send all rows in this frame
+#endif
+
 uint8_t u8g_dev_rrd_st7920_128x64_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, void *arg) {
   uint8_t i, y;
   switch (msg) {
@@ -133,6 +144,9 @@ uint8_t u8g_dev_rrd_st7920_128x64_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, vo
       }
       ST7920_WRITE_BYTE(0x0C); //display on, cursor+blink off
       ST7920_NCS();
+      #if ENABLED(ST7920_SEND_CHANGED_ROWS)
+        st7920_refresh_count = 0; // send the whole first frame
+      #endif
     }
     break;
 
@@ -144,8 +158,26 @@ uint8_t u8g_dev_rrd_st7920_128x64_fn(u8g_t *u8g, u8g_dev_t *dev, uint8_t msg, vo
       y = pb->p.page_y0;
       ptr = (uint8_t*)pb->buf;
 
+      #if ENABLED(ST7920_SEND_CHANGED_ROWS)
+        if (y == 0) { // first page of a new frame
+          st7920_send_all = !st7920_refresh_count;
+          st7920_refresh_count = st7920_send_all ? ST7920_FULL_REFRESH_FRAMES : st7920_refresh_count - 1;
+        }
+      #endif
+
       ST7920_CS();
       for (i = 0; i < PAGE_HEIGHT; i ++) {
+        #if ENABLED(ST7920_SEND_CHANGED_ROWS)
+          // Skip rows that are the same as last time
+          uint16_t crc = 0xFFFF;
+          for (uint8_t b = 0; b < (LCD_PIXEL_WIDTH) / 8; b++) crc = _crc16_update(crc, ptr[b]);
+          if (!st7920_send_all && crc == st7920_row_crc[y]) {
+            ptr += (LCD_PIXEL_WIDTH) / 8;
+            y++;
+            continue;
+          }
+          st7920_row_crc[y] = crc;
+        #endif
         ST7920_SET_CMD();
         if (y < 32) {
           ST7920_WRITE_BYTE(0x80 | y);       //y
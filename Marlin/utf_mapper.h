@@ -146,9 +146,16 @@
 
 #define PRINTABLE(C) (((C) & 0xC0u) != 0x80u)
 
+/**
+ * Each mapper decodes UTF-8 one byte at a time. When a character is complete
+ * it sets 'glyph' to the display's character code and returns 1. The leading
+ * bytes of a multibyte character return 0.
+ */
+#define MAPPED_CHAR(C) (glyph = (uint8_t)(C))
+
 #if ENABLED(MAPPER_C2C3)
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static uint8_t utf_hi_char; // UTF-8 high part
     static bool seen_c2 = false;
     uint8_t d = c;
@@ -161,17 +168,17 @@
       else if (seen_c2) {
         d &= 0x3Fu;
         #ifndef MAPPER_ONE_TO_ONE
-          HARDWARE_CHAR_OUT(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
+          MAPPED_CHAR(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
         #else
-          HARDWARE_CHAR_OUT(0x80u + (utf_hi_char << 6) + d);
+          MAPPED_CHAR(0x80u + (utf_hi_char << 6) + d);
         #endif
       }
       else {
-        HARDWARE_CHAR_OUT('?');
+        MAPPED_CHAR('?');
       }
     }
     else {
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
     }
     seen_c2 = false;
     return 1;
@@ -181,7 +188,7 @@
 
   // the C2C3-mapper extended for the 6 altered symbols from C4 and C5 range.
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static uint8_t utf_hi_char; // UTF-8 high part
     static bool seen_c2 = false,
                 seen_c4 = false,
@@ -203,7 +210,7 @@
           case 0xB1u: d = 0xFDu; break;
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c5) {
         switch(d) {
@@ -211,22 +218,22 @@
           case 0x9Fu: d = 0xFEu; break;
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c2) {
         d &= 0x3Fu;
         #ifndef MAPPER_ONE_TO_ONE
-          HARDWARE_CHAR_OUT(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
+          MAPPED_CHAR(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
         #else
-          HARDWARE_CHAR_OUT(0x80u + (utf_hi_char << 6) + d);
+          MAPPED_CHAR(0x80u + (utf_hi_char << 6) + d);
         #endif
       }
       else {
-        HARDWARE_CHAR_OUT('?');
+        MAPPED_CHAR('?');
       }
     }
     else {
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
     }
     seen_c2 = seen_c4 = seen_c5 = false;
     return 1;
@@ -234,7 +241,7 @@
 
 #elif ENABLED(MAPPER_CECF)
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static uint8_t utf_hi_char; // UTF-8 high part
     static bool seen_ce = false;
     uint8_t d = c;
@@ -247,17 +254,17 @@
       else if (seen_ce) {
         d &= 0x3F;
         #ifndef MAPPER_ONE_TO_ONE
-          HARDWARE_CHAR_OUT(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
+          MAPPED_CHAR(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
         #else
-          HARDWARE_CHAR_OUT(0x80 + (utf_hi_char << 6) + d);
+          MAPPED_CHAR(0x80 + (utf_hi_char << 6) + d);
         #endif
       }
       else {
-        HARDWARE_CHAR_OUT('?');
+        MAPPED_CHAR('?');
       }
     }
     else {
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
     }
     seen_ce = false;
     return 1;
@@ -265,7 +272,7 @@
 
 #elif ENABLED(MAPPER_CECF)
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static uint8_t utf_hi_char; // UTF-8 high part
     static bool seen_ce = false;
     uint8_t d = c;
@@ -278,17 +285,17 @@
       else if (seen_ce) {
         d &= 0x3F;
         #ifndef MAPPER_ONE_TO_ONE
-          HARDWARE_CHAR_OUT(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
+          MAPPED_CHAR(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
         #else
-          HARDWARE_CHAR_OUT(0x80 + (utf_hi_char << 6) + d);
+          MAPPED_CHAR(0x80 + (utf_hi_char << 6) + d);
         #endif
       }
       else {
-        HARDWARE_CHAR_OUT('?');
+        MAPPED_CHAR('?');
       }
     }
     else {
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
     }
     seen_ce = false;
     return 1;
@@ -296,7 +303,7 @@
 
 #elif ENABLED(MAPPER_D0D1_MOD)
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     // it is a Russian alphabet translation
     // except 0401 --> 0xA2 = Ё, 0451 --> 0xB5 = ё
     static uint8_t utf_hi_char; // UTF-8 high part
@@ -311,21 +318,21 @@
       else if (seen_d5) {
         d &= 0x3F;
         if (!utf_hi_char && d == 1) {
-          HARDWARE_CHAR_OUT(0xA2); // Ё
+          MAPPED_CHAR(0xA2); // Ё
         }
         else if (utf_hi_char == 1 && d == 0x11) {
-          HARDWARE_CHAR_OUT(0xB5); // ё
+          MAPPED_CHAR(0xB5); // ё
         }
         else {
-          HARDWARE_CHAR_OUT(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x10));
+          MAPPED_CHAR(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x10));
         }
       }
       else {
-        HARDWARE_CHAR_OUT('?');
+        MAPPED_CHAR('?');
       }
     }
     else {
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
     }
     seen_d5 = false;
     return 1;
@@ -333,7 +340,7 @@
 
 #elif ENABLED(MAPPER_D0D1)
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static uint8_t utf_hi_char; // UTF-8 high part
     static bool seen_d5 = false;
     uint8_t d = c;
@@ -346,17 +353,17 @@
       else if (seen_d5) {
         d &= 0x3Fu;
         #ifndef MAPPER_ONE_TO_ONE
-          HARDWARE_CHAR_OUT(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
+          MAPPED_CHAR(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
         #else
-          HARDWARE_CHAR_OUT(0xA0u + (utf_hi_char << 6) + d);
+          MAPPED_CHAR(0xA0u + (utf_hi_char << 6) + d);
         #endif
       }
       else {
-        HARDWARE_CHAR_OUT('?');
+        MAPPED_CHAR('?');
       }
     }
     else {
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
     }
     seen_d5 = false;
     return 1;
@@ -364,7 +371,7 @@
 
 #elif ENABLED(MAPPER_E382E383)
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static uint8_t utf_hi_char; // UTF-8 high part
     static bool seen_e3 = false,
                 seen_82_83 = false;
@@ -382,16 +389,16 @@
       else if (seen_e3 && seen_82_83) {
         d &= 0x3F;
         #ifndef MAPPER_ONE_TO_ONE
-          HARDWARE_CHAR_OUT(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
+          MAPPED_CHAR(pgm_read_byte_near(utf_recode + d + (utf_hi_char << 6) - 0x20));
         #else
-          HARDWARE_CHAR_OUT(0x80 + (utf_hi_char << 6) + d);
+          MAPPED_CHAR(0x80 + (utf_hi_char << 6) + d);
         #endif
       }
       else
-        HARDWARE_CHAR_OUT('?');
+        MAPPED_CHAR('?');
     }
     else
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
 
     seen_e3 = false;
     seen_82_83 = false;
@@ -421,7 +428,7 @@
    * ż C5 BC = 91
    */
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static bool seen_c3 = false,
                 seen_c4 = false,
                 seen_c5 = false;
@@ -436,7 +443,7 @@
           case 0x98u ... 0x99u: d -= 20; break; //Ę i ę
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c5) {
         switch(d) {
@@ -445,7 +452,7 @@
           case 0xB9u ... 0xBCu: d -= 0x2Bu; break; //Ź - ż
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c3) {
         switch(d) {
@@ -453,12 +460,12 @@
           case 0xB3u: d = 0x8Bu; break; //ó
           d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
 
     }
     else
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
 
     seen_c3 = seen_c4 = seen_c5 = false;
     return 1;
@@ -499,7 +506,7 @@
    * ž C5 BE = 9D
    */
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static bool seen_c3 = false,
                 seen_c4 = false,
                 seen_c5 = false;
@@ -514,7 +521,7 @@
           case 0x9Au ... 0x9Bu: d -= 10; break; // Ěě
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c5) {
         switch(d) {
@@ -526,7 +533,7 @@
           case 0xBDu ... 0xBEu: d -= 0x21u; break;  // Žž
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c3) {
         switch(d) {
@@ -544,12 +551,12 @@
           case 0xBDu: d = 0x8Bu; break;  // ý
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
 
     }
     else
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
 
     seen_c3 = seen_c4 = seen_c5 = false;
     return 1;
@@ -594,7 +601,7 @@
    * ž C5 BE = A1
    */
 
-  char charset_mapper(const char c) {
+  char utf_decode(const char c, uint8_t &glyph) {
     static bool seen_c3 = false,
                 seen_c4 = false,
                 seen_c5 = false;
@@ -610,7 +617,7 @@
           case 0xBDu ... 0xBEu: d -= 0x27u; break;  // Ľľ
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c5) {
         switch(d) {
@@ -621,7 +628,7 @@
           case 0xBDu ... 0xBEu: d -= 0x1Du; break;  // Žž
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
       else if (seen_c3) {
         switch(d) {
@@ -643,12 +650,12 @@
           case 0xBDu: d = 0x8Fu; break;  // ý
           default: d = '?';
         }
-        HARDWARE_CHAR_OUT(d);
+        MAPPED_CHAR(d);
       }
 
     }
     else
-      HARDWARE_CHAR_OUT(c);
+      MAPPED_CHAR(c);
 
     seen_c3 = seen_c4 = seen_c5 = false;
     return 1;
@@ -661,11 +668,91 @@
   #undef PRINTABLE
   #define PRINTABLE(C) true
 
-  char charset_mapper(const char c) {
-    HARDWARE_CHAR_OUT(c);
+  char utf_decode(const char c, uint8_t &glyph) {
+    MAPPED_CHAR(c);
     return 1;
   }
 
 #endif // code mappers
 
+char charset_mapper(const char c) {
+  uint8_t glyph = 0;
+  const char n = utf_decode(c, glyph);
+  if (glyph) HARDWARE_CHAR_OUT(glyph);
+  return n;
+}
+
+#ifndef MAPPER_NON
+
+  /**
+   * The status message decoded to display character codes. It is rebuilt
+   * only when the message changes, so redraws and scrolling don't decode
+   * the UTF-8 again.
+   */
+  static uint8_t status_glyphs[3 * (LCD_WIDTH)], status_glyph_count;
+  static bool status_glyphs_valid = false;
+
+  /**
+   * Call whenever lcd_status_message is changed
+   */
+  inline void lcd_status_changed() { status_glyphs_valid = false; }
+
+  static void update_status_glyphs() {
+    if (status_glyphs_valid) return;
+    status_glyphs_valid = true;
+    status_glyph_count = 0;
+    for (const char *s = lcd_status_message; *s && status_glyph_count < COUNT(status_glyphs); s++) {
+      uint8_t glyph = 0;
+      utf_decode(*s, glyph);
+      if (glyph) status_glyphs[status_glyph_count++] = glyph;
+    }
+  }
+
+  static void print_status_glyphs(const uint8_t start, uint8_t n) {
+    for (uint8_t i = start; n && i < status_glyph_count; --n) HARDWARE_CHAR_OUT(status_glyphs[i++]);
+  }
+
+  /**
+   * Draw the status message from the decoded copy, scrolling it if enabled
+   */
+  void lcd_print_status_glyphs(const bool blink) {
+    update_status_glyphs();
+    #if ENABLED(STATUS_MESSAGE_SCROLLING)
+      static bool last_blink = false;
+      const uint8_t slen = status_glyph_count;
+      if (slen <= LCD_WIDTH)
+        print_status_glyphs(0, LCD_WIDTH);                      // The string isn't scrolling
+      else {
+        if (status_scroll_pos <= slen - LCD_WIDTH)
+          print_status_glyphs(status_scroll_pos, LCD_WIDTH);    // The string fills the screen
+        else {
+          uint8_t chars = LCD_WIDTH;
+          if (status_scroll_pos < slen) {                       // First string still visible
+            print_status_glyphs(status_scroll_pos, LCD_WIDTH);  // The string leaves space
+            chars -= slen - status_scroll_pos;                  // Amount of space left
+          }
+          HARDWARE_CHAR_OUT('.');                               // Always at 1+ spaces left, draw a dot
+          if (--chars) {
+            if (status_scroll_pos < slen + 1)                   // Draw a second dot if there's space
+              --chars, HARDWARE_CHAR_OUT('.');
+            if (chars) print_status_glyphs(0, chars);           // Print a second copy of the message
+          }
+        }
+        if (last_blink != blink) {
+          last_blink = blink;
+          if (++status_scroll_pos >= slen + 2) status_scroll_pos = 0;
+        }
+      }
+    #else
+      UNUSED(blink);
+      print_status_glyphs(0, LCD_WIDTH);
+    #endif
+  }
+
+#else
+
+  inline void lcd_status_changed() {}
+
+#endif // !MAPPER_NON
+
 #endif // UTF_MAPPER_H
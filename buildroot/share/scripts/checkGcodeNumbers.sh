@@ -0,0 +1,117 @@
+#!/usr/bin/env bash
+#
+# checkGcodeNumbers.sh
+#
+# Compare the G-code number parsers in gcode.cpp with the C library on the host
+#
+# Usage: checkGcodeNumbers.sh [gcode files]
+#
+# GCodeParser::parse_float() is checked against strtof (avr-libc's strtod
+# returns a float) and parse_ulong() against strtoul. The corpus is a set of
+# generated values in typical G-code formats, plus every parameter value in
+# the given G-code files. Values with up to 7 significant digits must match
+# exactly, and longer ones to within one unit in the last place.
+#
+
+[ -d "Marlin" ] && cd "Marlin"
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# Take the parsers from gcode.cpp as they are
+awk '/^static const float powers_of_ten/{p=1} p{print} p&&/^uint32_t GCodeParser::parse_ulong/{u=1} u&&/^}/{exit}' gcode.cpp >"$TMP/parsers.inc"
+[ -s "$TMP/parsers.inc" ] || { echo "Parsers not found in gcode.cpp"; exit 1; }
+
+# Parameter values from the G-code files, one per line
+for F in "$@"; do
+  sed -e 's/;.*//' "$F" | grep -oE '[A-Za-z][-+]?[0-9]*\.?[0-9]+' | cut -c2-
+done >"$TMP/corpus.txt"
+
+cat >"$TMP/check.cpp" <<'EOF'
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <random>
+
+#define PROGMEM
+#define pgm_read_float(P) (*(P))
+#define NUMERIC(a) ((a) >= '0' && '9' >= (a))
+
+struct GCodeParser {
+  static float parse_float(const char *p);
+  static uint32_t parse_ulong(const char *p);
+};
+
+#include "parsers.inc"
+
+static long tested, exact, close_, bad;
+
+static uint8_t sig_digits(const char *s) {
+  uint8_t n = 0;
+  bool lead = true;
+  for (; *s; s++) {
+    if (*s < '0' || *s > '9') continue;
+    if (*s != '0') lead = false;
+    if (!lead) n++;
+  }
+  return n;
+}
+
+static int32_t ulps(const float a, const float b) {
+  int32_t ia, ib;
+  memcpy(&ia, &a, 4); memcpy(&ib, &b, 4);
+  if (ia < 0) ia = INT32_MIN - ia;
+  if (ib < 0) ib = INT32_MIN - ib;
+  return ia > ib ? ia - ib : ib - ia;
+}
+
+static void check(const char *s) {
+  tested++;
+  const float got = GCodeParser::parse_float(s), want = strtof(s, NULL);
+  const int32_t d = ulps(got, want);
+  if (!d) exact++;
+  else if (d == 1 && sig_digits(s) > 7) close_++;
+  else if (bad++ < 20) printf("parse_float(\"%s\") = %.9g, strtof = %.9g\n", s, got, want);
+
+  if (!strchr(s, '.')) {
+    const uint32_t u = GCodeParser::parse_ulong(s);
+    if (u != (uint32_t)strtoul(s, NULL, 10) && bad++ < 20)
+      printf("parse_ulong(\"%s\") = %lu, strtoul = %lu\n", s, (unsigned long)u, strtoul(s, NULL, 10));
+  }
+}
+
+int main(int argc, char **argv) {
+  char s[40];
+
+  // Values from G-code files
+  if (argc > 1) {
+    FILE *f = fopen(argv[1], "r");
+    while (f && fgets(s, sizeof(s), f)) { s[strcspn(s, "\n")] = '\0'; check(s); }
+    if (f) fclose(f);
+  }
+
+  // Generated values with 0 to 6 decimals, signs, and bare or trailing points
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> mag(-5, 5);
+  for (long i = 0; i < 2000000; i++) {
+    const double v = (rng() & 1 ? -1 : 1) * pow(10, mag(rng));
+    const int dec = rng() % 7;
+    sprintf(s, "%.*f", dec, v);
+    check(s);
+    if (v > 0 && (rng() & 7) == 0) { sprintf(s, "+%.*f", dec, v); check(s); }
+    if (!dec && (rng() & 7) == 0) { strcat(s, "."); check(s); }
+    if (fabs(v) < 1 && (rng() & 7) == 0) {
+      sprintf(s, "%.*f", dec ? dec : 3, fabs(v));
+      check(s + 1);   // ".5"
+    }
+  }
+  for (uint32_t u = 0; u < 100000; u++) { sprintf(s, "%lu", (unsigned long)(u * 42949UL)); check(s); }
+
+  printf("%ld values: %ld exact, %ld within 1 ulp (more than 7 digits), %ld bad\n", tested, exact, close_, bad);
+  return bad ? 1 : 0;
+}
+EOF
+
+${CXX:-g++} -O2 -include cmath -o "$TMP/check" "$TMP/check.cpp" || exit 1
+"$TMP/check" "$TMP/corpus.txt"
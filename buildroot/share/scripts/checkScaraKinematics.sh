@@ -0,0 +1,113 @@
+#!/usr/bin/env bash
+#
+# checkScaraKinematics.sh
+#
+# Check SCARA_FAST_KINEMATICS against the exact MORGAN_SCARA solution on the host
+#
+# Usage: checkScaraKinematics.sh [resync]
+#
+# inverse_kinematics() and scara_incremental_ik() are taken from Marlin_main.cpp
+# as they are, with the arm of the SCARA example configuration. Straight moves
+# in many directions across the reachable area are cut into segments of 0.25mm
+# (the shortest segment prepare_kinematic_move_to makes for SCARA) up to 2mm
+# (the longest step the incremental solver takes). Each segment's arm angles go
+# through double precision forward kinematics, and the distance from the target
+# must stay under 10um. The time per segment of both solvers is also printed.
+#
+
+[ -d "Marlin" ] && cd "Marlin"
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+# Take the Morgan SCARA kinematics from Marlin_main.cpp as they are
+awk '/^#if ENABLED\(MORGAN_SCARA\)/{p=1; n=0} p{b[n++]=$0} p&&/^#endif/{p=0; if ($0 ~ /MORGAN_SCARA/) for (i=1; i<n-1; i++) print b[i]}' Marlin_main.cpp >"$TMP/scara.inc"
+grep -q "scara_incremental_ik(" "$TMP/scara.inc" || { echo "SCARA kinematics not found in Marlin_main.cpp"; exit 1; }
+
+# Arm of the example configuration
+CFG=example_configurations/SCARA/Configuration.h
+grep -E "#define SCARA_(LINKAGE_[12]|OFFSET_[XY]) " "$CFG" >"$TMP/arm.h"
+
+cat >"$TMP/check.cpp" <<EOF
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+
+#define ENABLED(b) (b)
+#define SCARA_FAST_KINEMATICS 1
+#define SCARA_FAST_KINEMATICS_RESYNC ${1:-32}
+#include "arm.h"
+EOF
+cat >>"$TMP/check.cpp" <<'EOF'
+
+#define FORCE_INLINE inline
+#define XYZ 3
+enum AxisEnum { X_AXIS, Y_AXIS, Z_AXIS, A_AXIS = 0, B_AXIS, C_AXIS };
+#define sq(x) ((x)*(x))
+#define HYPOT2(x,y) (sq(x)+sq(y))
+#define SQRT(x) sqrtf(x)
+#define ATAN2(y,x) atan2f(y,x)
+#define FABS(x) fabsf(x)
+#define RADIANS(d) ((d)*float(M_PI)/180.0f)
+#define DEGREES(r) ((r)*180.0f/float(M_PI))
+
+const float L1 = SCARA_LINKAGE_1, L2 = SCARA_LINKAGE_2,
+            L1_2 = sq(float(L1)), L1_2_2 = 2.0 * L1_2,
+            L2_2 = sq(float(L2));
+float delta[XYZ], cartes[XYZ];
+
+#include "scara.inc"
+
+int main() {
+  const float seg_mm[] = { 0.25, 0.5, 1.0, 1.5, 2.0 };
+  const double reach_min = fabs(L1 - L2) + 30, reach_max = L1 + L2 - 10;
+  double worst = 0;
+
+  for (const float seg : seg_mm) {
+    double max_err = 0;
+    long segments = 0, stepped = 0;
+    for (int t = 0; t < 400; t++) {
+      // Moves in all directions, starting across the reachable area
+      const float x0 = -60 + t * 37 % 180, y0 = 40 + t * 53 % 150, ang = t * 0.7f,
+                  dx = cosf(ang) * seg, dy = sinf(ang) * seg;
+      scara_incremental_ik_reset();
+      for (int i = 1; i <= int(60 / seg); i++) {
+        const float raw[XYZ] = { x0 + dx * i, y0 + dy * i, 0 };
+        const double sx = raw[X_AXIS] - SCARA_OFFSET_X, sy = raw[Y_AXIS] - SCARA_OFFSET_Y,
+                     r = hypot(sx, sy);
+        if (r < reach_min || r > reach_max) break;
+
+        scara_incremental_ik(raw);
+        if (scara_resync_count != 1) stepped++;
+
+        const double a = delta[A_AXIS] * M_PI / 180, b = delta[B_AXIS] * M_PI / 180,
+                     err = hypot(L1 * cos(a) + L2 * cos(b) - sx, L1 * sin(a) + L2 * sin(b) - sy);
+        if (err > max_err) max_err = err;
+        segments++;
+      }
+    }
+    printf("%.2fmm segments: %ld, %ld%% incremental, max error %.2f um\n",
+      seg, segments, stepped * 100 / segments, max_err * 1000);
+    if (max_err > worst) worst = max_err;
+  }
+
+  // Time per segment along a 20mm move in 0.01um steps
+  volatile float sink = 0;
+  const long N = 2000000;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < N; i++) { const float raw[XYZ] = { -20 + i * 1e-5f, 100, 0 }; inverse_kinematics(raw); sink += delta[A_AXIS]; }
+  const auto t1 = std::chrono::steady_clock::now();
+  scara_incremental_ik_reset();
+  for (long i = 0; i < N; i++) { const float raw[XYZ] = { -20 + i * 1e-5f, 100, 0 }; scara_incremental_ik(raw); sink += delta[A_AXIS]; }
+  const auto t2 = std::chrono::steady_clock::now();
+  printf("Host time per segment: exact %.1f ns, incremental %.1f ns\n",
+    std::chrono::duration<double, std::nano>(t1 - t0).count() / N,
+    std::chrono::duration<double, std::nano>(t2 - t1).count() / N);
+
+  return worst > 0.010 ? 1 : 0;
+}
+EOF
+
+${CXX:-g++} -O2 -o "$TMP/check" "$TMP/check.cpp" || exit 1
+"$TMP/check"
@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+
+""" Simulate INPUT_SHAPING on one axis of a Cartesian printer.
+
+A trapezoidal move is stepped at the planner's step times and passed through
+the same integer shaper as Stepper::shaping_enqueue() and shaping_isr():
+gains in 1/256 step, delays in units of 16 timer ticks, a merge window, a
+queue of SHAPING_BUFFER_SIZE events, and a motor that steps whenever it is
+half a step off. The motor position then drives a damped mass-spring
+resonator. The residual ringing after the move is printed for no shaping
+and each shaper type, along with a check that the step counts are exact.
+"""
+
+from __future__ import print_function
+import argparse
+import math
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument('-f', '--freq', type=float, default=40, help='Shaper frequency in Hz (default=40)')
+parser.add_argument('-z', '--zeta', type=float, default=0.1, help='Shaper damping ratio (default=0.1)')
+parser.add_argument('--actual-freq', type=float, help='Resonator frequency in Hz (default=--freq)')
+parser.add_argument('--actual-zeta', type=float, help='Resonator damping ratio (default=--zeta)')
+parser.add_argument('-a', '--accel', type=float, default=3000, help='Acceleration in mm/s^2 (default=3000)')
+parser.add_argument('-v', '--feedrate', type=float, default=150, help='Feedrate in mm/s (default=150)')
+parser.add_argument('-d', '--distance', type=float, default=40, help='Move length in mm (default=40)')
+parser.add_argument('-s', '--steps-per-mm', type=float, default=80, help='Axis steps per mm (default=80)')
+parser.add_argument('-b', '--buffer', type=int, default=64, help='SHAPING_BUFFER_SIZE (default=64)')
+parser.add_argument('--cpu-freq', type=int, default=16, help='CPU clockrate in MHz (default=16)')
+args = parser.parse_args()
+
+F_CPU = args.cpu_freq * 1000000
+UNIT = 16.0 * 8 / F_CPU                 # Shaping clock unit: 16 ticks of Timer1 at F_CPU/8
+
+def step_times():
+  """ Times of the steps of a symmetric trapezoidal move from rest to rest """
+  steps = int(round(args.distance * args.steps_per_mm))
+  a, v = args.accel * args.steps_per_mm, args.feedrate * args.steps_per_mm
+  ramp = min(v * v / (2 * a), steps / 2.0)
+  v = math.sqrt(2 * a * ramp)
+  t_ramp, t_cruise = v / a, (steps - 2 * ramp) / v
+  times = []
+  for n in range(1, steps + 1):
+    if n <= ramp:
+      t = math.sqrt(2 * n / a)
+    elif n <= steps - ramp:
+      t = t_ramp + (n - ramp) / v
+    else:
+      t = 2 * t_ramp + t_cruise - math.sqrt(2 * (steps - n) / a)
+    times.append(t)
+  return times
+
+def echoes(shaper):
+  """ Impulse gains and delays, as in Stepper::refresh_shaping() """
+  zeta = args.zeta
+  root = math.sqrt(1 - zeta * zeta)
+  if shaper == 'MZV':
+    K = math.exp(-0.75 * zeta * math.pi / root)
+    a1, a2, a3, delay = 1 - math.sqrt(0.5), (math.sqrt(2) - 1) * K, (1 - math.sqrt(0.5)) * K * K, 0.375
+  else:
+    K = math.exp(-zeta * math.pi / root)
+    a1, a2, a3, delay = 1, (2 * K if shaper == 'ZVD' else K), (K * K if shaper == 'ZVD' else 0), 0.5
+  scale = 256 / (a1 + a2 + a3)
+  g2, g3 = int(round(a2 * scale)), int(round(a3 * scale))
+  d = int(round(delay * (F_CPU / 128) / (args.freq * root)))
+  result = [(d, g2)]
+  if g3: result.append((d * 2, g3))
+  return 256 - g2 - g3, result
+
+def shape(times, shaper):
+  """ Motor steps for the commanded steps, and the impulses before rounding to steps """
+  out, ideal = [], []
+  if not shaper:
+    return [(t, 1) for t in times], [(t, 1) for t in times]
+
+  gain, echo = echoes(shaper)
+  longest = max(d for d, g in echo)
+  window = max(1, longest // (args.buffer - 2))
+  state = {'frac': 0}
+
+  def move(t, amount):
+    ideal.append((t, amount / 256.0))
+    state['frac'] += amount
+    while state['frac'] > 127 or state['frac'] < -128:
+      d = 1 if state['frac'] > 0 else -1
+      state['frac'] -= d * 256
+      out.append((t, d))
+
+  queue = []                            # [time in units, steps, echoes taken]
+  for t in times:
+    now = int(t / UNIT)
+
+    # Take the echoes that fell due since the last step, at their own times
+    due = []
+    for e, (d, g) in enumerate(echo):
+      for ev in queue:
+        if ev[2] == e and now - ev[0] >= d:
+          due.append(((ev[0] + d) * UNIT, ev[1] * g))
+          ev[2] += 1
+    for due_t, amount in sorted(due): move(due_t, amount)
+    queue = [ev for ev in queue if ev[2] < len(echo)]
+
+    move(t, gain)
+    full = len(queue) >= args.buffer - 1
+    if queue and queue[-1][2] == 0 and (full or now - queue[-1][0] < window) and queue[-1][1] < 127:
+      queue[-1][1] += 1
+    elif full:
+      for d, g in echo: move(t, g)
+    else:
+      queue.append([now, 1, 0])
+
+  # Drain the queue after the last step
+  for e, (d, g) in enumerate(echo):
+    for ev in queue:
+      if ev[2] == e:
+        move((ev[0] + d) * UNIT, ev[1] * g)
+        ev[2] += 1
+  out.sort()
+  ideal.sort()
+  return out, ideal
+
+def ringing(steps):
+  """ Peak deviation (mm) of a resonator from the motor after the move, and the motor travel """
+  f = args.actual_freq or args.freq
+  zeta = args.zeta if args.actual_zeta is None else args.actual_zeta
+  w = 2 * math.pi * f
+  dt = 5e-6
+  end = steps[-1][0]
+  x = v = u = 0.0
+  i, t, peak = 0, 0.0, 0.0
+  while t < end + 10 / f:
+    u0 = u
+    while i < len(steps) and steps[i][0] <= t:
+      u += steps[i][1] / args.steps_per_mm
+      i += 1
+    # The spring and damper both act between the motor and the mass
+    v += (-w * w * (x - u) - 2 * zeta * w * (v - (u - u0) / dt)) * dt
+    x += v * dt
+    t += dt
+    if t > end: peak = max(peak, abs(x - u))
+  return peak, u
+
+times = step_times()
+print("%g mm at %g mm/s^2 and %g mm/s, shaper %g Hz zeta %g, resonator %g Hz zeta %g" % (
+  args.distance, args.accel, args.feedrate, args.freq, args.zeta,
+  args.actual_freq or args.freq, args.zeta if args.actual_zeta is None else args.actual_zeta))
+exact = True
+print("Residual ringing of the motor steps, and of the impulses before rounding to steps:")
+for shaper in (None, 'ZV', 'ZVD', 'MZV'):
+  steps, ideal = shape(times, shaper)
+  peak, travel = ringing(steps)
+  count = sum(d for t, d in steps)
+  exact = exact and count == len(times)
+  print("%-5s %6.2f um %6.2f um  %d steps%s" % (shaper or 'none', peak * 1000, ringing(ideal)[0] * 1000,
+    count, '' if count == len(times) else ' (WRONG)'))
+exit(0 if exact else 1)